@@ -0,0 +1,206 @@
+/**
+ * @file   mix_cache.c
+ * @author Benjamin Gerard AKA Ben/OVR
+ * @date   2026-10-16
+ * @brief  Rendered note cache.
+ */
+
+#define ZZ_DBG_PREFIX "(nce) "
+#include "zz_private.h"
+
+/* GB: Quartet songs play the same few notes over and over. A note
+ *     that does not slide always renders the same pcm from its start
+ *     so the first voice playing it stores what it renders and the
+ *     next ones only copy it. Entries grow block by block as long as
+ *     a voice renders at their end. The memory budget is split in
+ *     blocks; the least recently used entry gives its blocks back
+ *     when none are left.
+ */
+#define NCE_MAX 64			/* number of entries */
+#define NCE_BLK 512			/* pcm per block */
+#define NCE_BLKS 64			/* blocks per entry */
+
+struct nce_s {
+  u32_t ins;				/**< instrument.          */
+  u32_t xtp;				/**< resampling step.     */
+  u32_t use;				/**< last use (LRU).      */
+  u32_t len;				/**< pcm stored.          */
+  u16_t ref;				/**< number of voices.    */
+  u16_t nbk;				/**< number of blocks.    */
+  u16_t bk[NCE_BLKS];			/**< blocks.              */
+};
+
+struct ncache_s {
+  int16_t * pcm;			/**< blocks storage.      */
+  u16_t   * fre;			/**< free blocks.         */
+  u16_t     nfr;			/**< number of free ones. */
+  u16_t     nbk;			/**< number of blocks.    */
+  u16_t     nce;			/**< entries in use.      */
+  u32_t     use;			/**< LRU clock.           */
+  nce_t     ent[NCE_MAX];
+};
+
+zz_err_t
+ncache_new(ncache_t ** pnc, u32_t size)
+{
+  ncache_t * nc = 0;
+  u32_t nbk = size / (NCE_BLK*sizeof(int16_t));
+  zz_err_t ecode;
+
+  zz_assert( pnc );
+  zz_assert( ! *pnc );
+  if (nbk > 0xFFFF)
+    nbk = 0xFFFF;
+  if (!nbk)
+    return E_OK;
+  if ( (ecode = zz_calloc(&nc, sizeof(*nc))) )
+    return ecode;
+  if ( (ecode = zz_malloc(&nc->pcm, mulu32(nbk, NCE_BLK*sizeof(int16_t))))
+       || (ecode = zz_malloc(&nc->fre, nbk*sizeof(u16_t))) ) {
+    ncache_del(&nc);
+    return ecode;
+  }
+  for (nc->nbk = 0; nc->nbk < nbk; ++nc->nbk)
+    nc->fre[nc->nbk] = nbk-1-nc->nbk;
+  nc->nfr = nbk;
+  dmsg("%hu blocks of %hu pcm\n", HU(nbk), HU(NCE_BLK));
+  *pnc = nc;
+  return E_OK;
+}
+
+void
+ncache_del(ncache_t ** pnc)
+{
+  ncache_t * const nc = *pnc;
+
+  if (nc) {
+    dmsg("%hu entries, %hu/%hu blocks in use\n",
+         HU(nc->nce), HU(nc->nbk-nc->nfr), HU(nc->nbk));
+    zz_free(&nc->fre);
+    zz_free(&nc->pcm);
+    zz_free(pnc);
+  }
+}
+
+/* Forget an entry and give its blocks back. */
+static void
+nce_drop(ncache_t * const nc, nce_t * const E)
+{
+  zz_assert( !E->ref );
+  while (E->nbk)
+    nc->fre[nc->nfr++] = E->bk[--E->nbk];
+  E->len = 0;
+  E->use = 0;
+}
+
+/* Least recently used entry not in use by a voice (0:none). */
+static nce_t *
+nce_lru(ncache_t * const nc, const nce_t * const keep, const u8_t blocks)
+{
+  nce_t * E, * L = 0;
+
+  for (E = nc->ent; E < nc->ent+nc->nce; ++E)
+    if (!E->ref && E != keep && (!blocks || E->nbk)
+        && (!L || E->use < L->use))
+      L = E;
+  return L;
+}
+
+nce_t *
+ncache_get(ncache_t * const nc, const u32_t ins, const u32_t xtp,
+           u8_t * const hit)
+{
+  nce_t * E;
+
+  *hit = 0;
+  if (!nc)
+    return 0;
+
+  for (E = nc->ent; E < nc->ent+nc->nce; ++E)
+    if (E->ins == ins && E->xtp == xtp && E->use)
+      break;
+
+  if (E < nc->ent+nc->nce)
+    *hit = 1;
+  else {
+    if (nc->nce < NCE_MAX)
+      E = nc->ent + nc->nce++;
+    else if ( (E = nce_lru(nc, 0, 0)) )
+      nce_drop(nc, E);
+    else
+      return 0;
+    E->ins = ins;
+    E->xtp = xtp;
+  }
+  E->use = ++nc->use;
+  ++E->ref;
+  return E;
+}
+
+void
+ncache_put(ncache_t * const nc, nce_t ** const pE)
+{
+  nce_t * const E = *pE;
+
+  if (E) {
+    zz_assert( nc );
+    zz_assert( E->ref );
+    --E->ref;
+    *pE = 0;
+  }
+}
+
+int
+ncache_read(const ncache_t * const nc, const nce_t * const E,
+            u32_t pos, int16_t * d, int n)
+{
+  int r = 0;
+
+  if (pos >= E->len)
+    return 0;
+  if ((u32_t) n > E->len - pos)
+    n = E->len - pos;
+  while (n > 0) {
+    const u32_t o = pos % NCE_BLK;
+    const int m = NCE_BLK - o < (u32_t) n ? (int) ( NCE_BLK - o ) : n;
+    zz_memcpy(d, nc->pcm + mulu32(E->bk[pos/NCE_BLK], NCE_BLK) + o,
+              m * sizeof(int16_t));
+    d += m; pos += m; n -= m; r += m;
+  }
+  return r;
+}
+
+int
+ncache_write(ncache_t * const nc, nce_t * const E,
+             const u32_t pos, const int16_t * s, int n)
+{
+  int r = 0;
+
+  if (pos != E->len)
+    return 0;
+  while (n > 0) {
+    const u32_t o = E->len % NCE_BLK;
+    int m;
+
+    if (!o) {
+      nce_t * L;
+      if (E->nbk == NCE_BLKS)
+        break;
+      if (!nc->nfr) {
+        /* GB: Only a new note can take the blocks of another one,
+         *     growing ones would push each other out in turn. */
+        if ( E->nbk || ! (L = nce_lru(nc, E, 1)) )
+          break;
+        dmsg("drop I#%02hu/%08lx %lu pcm\n",
+             HU(L->ins+1), LU(L->xtp), LU(L->len));
+        nce_drop(nc, L);
+      }
+      E->bk[E->nbk++] = nc->fre[--nc->nfr];
+    }
+    m = NCE_BLK - o < (u32_t) n ? (int) ( NCE_BLK - o ) : n;
+    zz_memcpy(nc->pcm + mulu32(E->bk[E->len/NCE_BLK], NCE_BLK) + o, s,
+              m * sizeof(int16_t));
+    s += m; E->len += m; n -= m; r += m;
+  }
+  return r;
+}
@@ -2,7 +2,7 @@
  * @file   mix_common.c
  * @author Benjamin Gerard AKA Ben/OVR
  * @date   2017-07-04
- * @brief  common parts for none, lerp and qerp mixer.
+ * @brief  common parts for none, lerp, qerp and mip mixer.
  */
 
 #ifndef NAME
@@ -21,38 +21,99 @@
 #define str(X) #X
 
 #include <string.h>
+#include <stddef.h>
 
 typedef struct mix_fp_s mix_fp_t;
 typedef struct mix_chan_s mix_chan_t;
 
 #define BLKMAX 64
 
+#ifndef PCMT
+# define PCMT uint8_t			/* instrument pcm type */
+#endif
+
 struct mix_chan_s {
-  uint8_t *pcm, *end;
+  PCMT *pcm, *end;
   u32_t idx, lpl, len, xtp;
-  i16_t buf[BLKMAX];
+#ifdef CHANDATA
+  CHANDATA				/* method specific voice data */
+#endif
+  int16_t buf[BLKMAX];
+#ifdef NCACHE
+  nce_t * nce;				/* cached note (0:none) */
+  u32_t pos;				/* pcm since the note start */
+#endif
 };
 
 struct mix_fp_s {
   mix_chan_t chan[4];
+#ifdef NCACHE
+  ncache_t * nc;			/* rendered note cache */
+#endif
+#ifdef MIXDATA
+  MIXDATA				/* method specific data */
+#endif
 };
 
+/* Mixer counters (zz_stats_s::mix). The method ones follow the
+ * note cache ones. */
+#ifdef NCACHE
+enum { STAT_HIT, STAT_MISS, STAT_PCM, STAT_MIX };
+# define NCACHE_STATS "cache hits", "cache misses", "cache pcm",
+#else
+enum { STAT_MIX };
+# define NCACHE_STATS
+#endif
+#ifndef MIXSTATS
+# define MIXSTATS
+#endif
+
 #define SETPCM() OPEPCM(=);
 #define ADDPCM() OPEPCM(+=);
 
-static inline void
-mix_blk(mix_chan_t * const restrict K, int n)
+/* Number of pcm until the end is reached (last one included). */
+static inline int
+run_len(const u32_t idx, const u32_t stp, const u32_t len, const int n)
 {
-  const uint8_t * const pcm = (const uint8_t *)K->pcm;
+  const u32_t m = ( len - idx - 1u ) / stp + 1u;
+  return m < (u32_t) n ? m : n;
+}
+
+/* Mix n pcm not going past the end but with the last one. */
+static inline u32_t
+mix_run(mix_chan_t * const restrict K, int16_t * restrict b,
+        u32_t idx, int n)
+{
+#ifdef MIXRUN
+  /* GB: The method runs the voice its own way. */
+  return MIXRUN(K, b, idx, n);
+#else
+  const PCMT * const pcm = K->pcm;
   const u32_t stp = K->xtp;
+
+# ifdef SIMDRUN
+  /* GB: Vector kernels do what they can, we finish the job. */
+  const int r = SIMDRUN(b, pcm, idx, stp, n, K->end - K->pcm);
+  b   += r;
+  idx += r * stp;
+  n   -= r;
+# endif
+  for ( ; n > 0; --n)
+    SETPCM();
+  return idx;
+#endif
+}
+
+/* Mix n pcm into b, returns the number of pcm before the end. */
+static inline int
+mix_blk(mix_chan_t * const restrict K, int16_t * b, int n)
+{
+  int16_t * const org = b;
   u32_t idx = K->idx;
-  i16_t * b;
 
   zz_assert( n >= 0 );
   if (n <= 0)
-    return;
-
-  b = K->buf;
+    return 0;
 
   if ( K->pcm ) {
     zz_assert( n <= BLKMAX );
@@ -63,20 +124,21 @@ mix_blk(mix_chan_t * const restrict K, int n)
 
     if (!K->lpl) {
       /* Instrument does not loop */
-      do {
-        SETPCM();
-        /* Have reach end ? */
-        if ( unlikely (idx >= K->len) ) {
-          K->pcm = 0;                     /* This only is mandatory */
-          --n;
-          break;
-        }
-      } while (--n);
+      const int m = run_len(idx, K->xtp, K->len, n);
+      idx = mix_run(K, b, idx, m);
+      b += m;
+      n -= m;
+      /* Have reach end ? */
+      if (idx >= K->len)
+        K->pcm = 0;                       /* This only is mandatory */
     } else {
       const u32_t off = K->len - K->lpl;  /* loop start index */
       /* Instrument does loop */
       do {
-        SETPCM();
+        const int m = run_len(idx, K->xtp, K->len, n);
+        idx = mix_run(K, b, idx, m);
+        b += m;
+        n -= m;
         /* Have reach end ? */
         if (idx >= K->len) {
           u32_t ovf = idx - K->len;
@@ -84,16 +146,192 @@ mix_blk(mix_chan_t * const restrict K, int n)
           idx = off+ovf;
           zz_assert( idx >= off && idx < K->len );
         }
-      } while (--n);
+      } while (n);
     }
   }
   K->idx = idx;
-  if (n > 0)
+  if (n > 0) {
+    const int m = b - org;
     do {
       *b++ = 0;
     } while (--n);
+    return m;
+  }
+  return b - org;
+}
+
+/* Loop or stop a voice that has reached its end. */
+static inline u32_t
+mix_wrap(mix_chan_t * const K, u32_t idx)
+{
+  if (idx >= K->len) {
+    if (!K->lpl)
+      K->pcm = 0;
+    else {
+      u32_t ovf = idx - K->len;
+      if (ovf >= K->lpl) ovf %= K->lpl;
+      idx = K->len - K->lpl + ovf;
+    }
+  }
+  return idx;
+}
+
+/* Advance the voice by n pcm without mixing them (as mix_blk()). */
+static inline void
+mix_skip(mix_chan_t * const restrict K, int n)
+{
+  const u32_t stp = K->xtp;
+  u32_t idx = K->idx;
+
+  while (n > 0 && K->pcm) {
+    const int m = run_len(idx, stp, K->len, n);
+    idx = mix_wrap(K, idx + m * stp);
+    n  -= m;
+  }
+  K->idx = idx;
+}
+
+#ifdef GETPCM
+
+#ifndef FUSEMIN
+# define FUSEMIN 16			/* shortest fused run (pcm) */
+#endif
+
+/* Silent pcm read by stopped voices. */
+static const uint8_t fuse_zero[8] = {
+  128, 128, 128, 128, 128, 128, 128, 128
+};
+
+/* GB: Resample and mix the 4 voices to 16-bit stereo in one pass
+ *     (reference of the fused vector kernels). The sum of the two
+ *     voices of a side scaled by 256 at most never goes past 16-bit
+ *     after the shift so there is nothing to clip. The lr8 mode is
+ *     a constant once inlined (0:any 1:lr8=0 2:lr8=128 3:lr8=256).
+ */
+static inline void always_inline
+fuse_run(int16_t * restrict d, mix_fuse_t * const v,
+         const i32_t lr8, const int n, const int mode)
+{
+  const i32_t sc1 = 256-lr8, sc2 = lr8;
+  const uint8_t * const pa = v[0].pcm, * const pb = v[1].pcm;
+  const uint8_t * const pc = v[2].pcm, * const pd = v[3].pcm;
+  u32_t ia = v[0].idx, ib = v[1].idx, ic = v[2].idx, id = v[3].idx;
+  int k;
+
+  for (k=0; k<n; ++k, d+=2) {
+    const i32_t ab = GETPCM(pa,ia) + GETPCM(pb,ib);
+    const i32_t cd = GETPCM(pc,ic) + GETPCM(pd,id);
+
+    ia += v[0].stp; ib += v[1].stp; ic += v[2].stp; id += v[3].stp;
+    switch (mode) {
+    case 1:  d[0] = ab >> 1; d[1] = cd >> 1; break;
+    case 2:  d[0] = d[1] = ( ab + cd ) >> 2; break;
+    case 3:  d[0] = cd >> 1; d[1] = ab >> 1; break;
+    default:
+      d[0] = ( ab * sc1 + cd * sc2 ) >> 9;
+      d[1] = ( ab * sc2 + cd * sc1 ) >> 9;
+    }
+  }
+  v[0].idx = ia; v[1].idx = ib; v[2].idx = ic; v[3].idx = id;
+}
+
+/* Mix up to n pcm in one pass as long as no voice reaches its end.
+ * Returns the number of pcm mixed (0: use the voice buffers). */
+static int
+mix_fuse(mix_fp_t * const M, int16_t * restrict d, const int lr8, int n)
+{
+  mix_fuse_t v[4];
+  int k, r = 0;
+
+  for (k=0; k<4; ++k) {
+    const mix_chan_t * const K = M->chan+k;
+    if (!K->pcm) {
+      v[k].pcm = fuse_zero;
+      v[k].idx = v[k].stp = 0;
+      v[k].lim = sizeof(fuse_zero);
+    } else {
+#ifdef NCACHE
+      if (K->nce)
+        return 0;
+#endif
+      n = run_len(K->idx, K->xtp, K->len, n);
+      v[k].pcm = K->pcm;
+      v[k].idx = K->idx;
+      v[k].stp = K->xtp;
+      v[k].lim = K->end - K->pcm;
+    }
+  }
+  if (n < FUSEMIN)
+    return 0;
+
+#ifdef FUSERUN
+  /* GB: Vector kernels do what they can, we finish the job. When
+   *     there are none the separate vector kernels are faster. */
+  if ( (r = FUSERUN(d, v, lr8, n)) < 0 )
+    return 0;
+  d += 2*r;
+#endif
+  switch (lr8) {
+  case 0:   fuse_run(d, v, lr8, n-r, 1); break;
+  case 128: fuse_run(d, v, lr8, n-r, 2); break;
+  case 256: fuse_run(d, v, lr8, n-r, 3); break;
+  default:  fuse_run(d, v, lr8, n-r, 0); break;
+  }
+
+  for (k=0; k<4; ++k) {
+    mix_chan_t * const K = M->chan+k;
+    if (K->pcm)
+      K->idx = mix_wrap(K, v[k].idx);
+  }
+  return n;
+}
+
+#endif /* GETPCM */
+
+#ifdef NCACHE
+
+/* Mix n pcm reading as much as possible from the cached note then
+ * storing what has been mixed past its end. */
+static inline void
+mix_note(core_t * const P, ncache_t * const nc,
+         mix_chan_t * const restrict K, const int n)
+{
+  int m = 0, a;
+
+  if (K->nce && K->pcm) {
+    m = ncache_read(nc, K->nce, K->pos, K->buf, n);
+    STATS_MIX(P,STAT_PCM,m);
+    mix_skip(K, m);
+    K->pos += m;
+  }
+  a = mix_blk(K, K->buf+m, n-m);
+  if (K->nce && a) {
+    /* GB: Stop storing once the cache is full for this note. */
+    if (ncache_write(nc, K->nce, K->pos, K->buf+m, a) < a)
+      ncache_put(nc, &K->nce);
+    K->pos += a;
+  }
+  if (!K->pcm)
+    ncache_put(nc, &K->nce);
+}
+
+/* Attach a freshly triggered note to the cache. */
+static void
+mix_note_get(core_t * const P, ncache_t * const nc,
+             mix_chan_t * const K, const chan_t * const C)
+{
+  u8_t hit;
+
+  K->nce = ncache_get(nc, C->note.ins - P->vset.inst, K->xtp, &hit);
+  K->pos = 0;
+  if (K->nce) {
+    STATS_MIX(P,STAT_HIT,hit);
+    STATS_MIX(P,STAT_MISS,!hit);
+  }
 }
 
+#endif /* NCACHE */
+
 static u32_t xstep(u32_t stp, u32_t ikhz, u32_t ohz)
 {
   /* stp is fixed-point 16
@@ -110,20 +348,18 @@ static u32_t xstep(u32_t stp, u32_t ikhz, u32_t ohz)
   return res;
 }
 
-static i16_t
-push_cb(core_t * const P, void * restrict pcm, i16_t N)
+#ifndef VOXSPR
+# define VOXSPR(P,M) (P)->spr		/* voices sampling rate */
+#endif
+
+/* Setup channels for the pending triggers. */
+static int
+mix_trig(core_t * const P, mix_fp_t * const M)
 {
-  mix_fp_t * const M = (mix_fp_t *)P->data;
   int k;
-  i16_t rem = N;
 
-  zz_assert( P );
-  zz_assert( M );
-  zz_assert( pcm );
-  zz_assert( N != 0 );
-  zz_assert( N > 0 );
+  STATS_ADD(P,notes,stats_notes(P));
 
-  /* Setup channels */
   for (k=0; k<4; ++k) {
     chan_t     * const C = P->chan+k;
     mix_chan_t * const K = M->chan + C->pam;
@@ -134,13 +370,19 @@ push_cb(core_t * const P, void * restrict pcm, i16_t N)
     case TRIG_NOTE:
       zz_assert( C->note.ins == P->vset.inst+C->curi );
       K->idx = 0;
-      K->pcm = C->note.ins->pcm;
+      K->pcm = (PCMT *) C->note.ins->pcm;
       K->len = C->note.ins->len << FP;
       K->lpl = C->note.ins->lpl << FP;
       K->end = C->note.ins->end + K->pcm;
 
     case TRIG_SLIDE:
-      K->xtp = xstep(C->note.cur, P->song.khz, P->spr);
+      K->xtp = xstep(C->note.cur, P->song.khz, VOXSPR(P,M));
+#ifdef MIXPICK
+      /* GB: Let the method choose the pcm for this step (and
+       *     adjust the note on TRIG_NOTE). */
+      if (K->pcm)
+        MIXPICK(P, M, K, C, trig);
+#endif
       break;
 
     case TRIG_STOP: K->pcm = 0;
@@ -150,27 +392,110 @@ push_cb(core_t * const P, void * restrict pcm, i16_t N)
       zz_assert( !"wtf" );
       return -1;
     }
+
+#ifdef NCACHE
+    /* GB: Only notes that do not slide (yet) are cached. */
+    if (trig != TRIG_NOP) {
+      ncache_put(M->nc, &K->nce);
+      if (trig == TRIG_NOTE && K->pcm && !C->note.stp)
+        mix_note_get(P, M->nc, K, C);
+    }
+#endif
   }
+  return 0;
+}
+
+/* Mix N pcm of the 4 voices to pcm format fmt. */
+static void
+mix_voices(core_t * const P, mix_fp_t * const M,
+           void * restrict pcm, const u8_t fmt, int rem)
+{
+  int k;
+  STATS_START(P,t);
 
   zz_assert( P->lr8 <= 256 );
   while (rem > 0) {
-    const int n = rem < BLKMAX ? rem : BLKMAX;
+    int n;
+
+#ifdef GETPCM
+    if (fmt == ZZ_PCM_I16 && (n = mix_fuse(M, pcm, P->lr8, rem))) {
+      rem -= n;
+      pcm = (int16_t *) pcm + 2*n;
+      STATS_STAGE(P,voice,t,4*n);
+      continue;
+    }
+#endif
+    n = rem < BLKMAX ? rem : BLKMAX;
     rem -= n;
 
     /* src voices */
     for (k=0; k<4; ++k)
-      mix_blk(M->chan+k, n);
+#ifdef NCACHE
+      mix_note(P, M->nc, M->chan+k, n);
+#else
+      mix_blk(M->chan+k, M->chan[k].buf, n);
+#endif
+    STATS_STAGE(P,voice,t,4*n);
 
-    map_i16_to_i16(pcm,
-                   M->chan[0].buf, M->chan[1].buf,
-                   M->chan[2].buf, M->chan[3].buf,
-                   256-P->lr8, P->lr8, n);
-    pcm = ((int32_t*)pcm) + n;
+    pcm = map_i16_to_pcm(pcm, fmt,
+                         M->chan[0].buf, M->chan[1].buf,
+                         M->chan[2].buf, M->chan[3].buf,
+                         256-P->lr8, P->lr8, n);
+    STATS_STAGE(P,map,t,n);
   }
+}
+
+#ifndef PUSHCB
+
+static i16_t
+push_cb(core_t * const P, void * restrict pcm, i16_t N)
+{
+  mix_fp_t * const M = (mix_fp_t *)P->data;
+  STATS_START(P,t);
+
+  zz_assert( P );
+  zz_assert( M );
+  zz_assert( pcm );
+  zz_assert( N != 0 );
+  zz_assert( N > 0 );
+
+  if (mix_trig(P, M))
+    return -1;
+  STATS_STAGE(P,trig,t,1);
+
+  mix_voices(P, M, pcm, P->pcmfmt, N);
+  STATS_ADD(P,clips,mix_clips(pcm, P->pcmfmt, N));
 
   return N;
 }
 
+# define PUSHCB push_cb
+#endif /* PUSHCB */
+
+#ifndef SKIPCB
+
+/* Same as push_cb() without mixing. */
+static i16_t
+skip_cb(core_t * const P, i16_t N)
+{
+  mix_fp_t * const M = (mix_fp_t *)P->data;
+  int k;
+
+  zz_assert( N > 0 );
+  if (mix_trig(P, M))
+    return -1;
+  for (k=0; k<4; ++k) {
+#ifdef NCACHE
+    ncache_put(M->nc, &M->chan[k].nce);
+#endif
+    mix_skip(M->chan+k, N);
+  }
+  return N;
+}
+
+# define SKIPCB skip_cb
+#endif /* SKIPCB */
+
 static void * local_calloc(u32_t size, zz_err_t * err)
 {
   void * ptr = 0;
@@ -198,6 +523,10 @@ static zz_err_t init_cb(core_t * const P, u32_t spr)
     P->spr = spr;
 
     ecode = init_meth(P);
+#ifdef NCACHE
+    if (!ecode)
+      ecode = ncache_new(&M->nc, NCACHE_SIZE);
+#endif
   }
 
   return ecode;
@@ -205,10 +534,64 @@ static zz_err_t init_cb(core_t * const P, u32_t spr)
 
 static void free_cb(core_t * const P)
 {
+#ifdef FREEMETH
+  if (P->data)
+    FREEMETH(P);
+#endif
+#ifdef NCACHE
+  if (P->data)
+    ncache_del(&((mix_fp_t *)P->data)->nc);
+#endif
   zz_memdel(&P->data);
 }
 
+/* GB: Voice buffers are scratch memory; they are not part of the
+ *     mixer state. Neither are cached notes, a restored voice mixes
+ *     its note instead.
+ */
+#define CHAN_STATE offsetof(mix_chan_t,buf)
+
+#ifdef MIXSAVE
+# define MIX_STATE sizeof(((mix_fp_t *)0)->MIXSAVE)
+#else
+# define MIX_STATE 0
+#endif
+
+static u32_t save_cb(core_t * const P, void * buf)
+{
+  const mix_fp_t * const M = (const mix_fp_t *)P->data;
+  int k;
+
+  if (buf) {
+    for (k=0; k<4; ++k)
+      zz_memcpy((uint8_t *)buf + k*CHAN_STATE, M->chan+k, CHAN_STATE);
+#ifdef MIXSAVE
+    zz_memcpy((uint8_t *)buf + 4*CHAN_STATE, &M->MIXSAVE, MIX_STATE);
+#endif
+  }
+  return 4 * CHAN_STATE + MIX_STATE;
+}
+
+static void restore_cb(core_t * const P, const void * buf)
+{
+  mix_fp_t * const M = (mix_fp_t *)P->data;
+  int k;
+
+  for (k=0; k<4; ++k) {
+#ifdef NCACHE
+    ncache_put(M->nc, &M->chan[k].nce);
+#endif
+    zz_memcpy(M->chan+k, (const uint8_t *)buf + k*CHAN_STATE, CHAN_STATE);
+  }
+#ifdef MIXSAVE
+  zz_memcpy(&M->MIXSAVE, (const uint8_t *)buf + 4*CHAN_STATE, MIX_STATE);
+#endif
+}
+
+static const char * const mix_stats[] = { NCACHE_STATS MIXSTATS 0 };
+
 mixer_t SYMB =
 {
-  NAME ":" METH, DESC, init_cb, free_cb, push_cb
+  NAME ":" METH, DESC, init_cb, free_cb, PUSHCB, save_cb, restore_cb,
+  SKIPCB, mix_stats
 };
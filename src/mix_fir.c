@@ -0,0 +1,92 @@
+/**
+ * @file   mix_fir.c
+ * @author Benjamin Gerard AKA Ben/OVR
+ * @date   2026-10-16
+ * @brief  Polyphase windowed sinc over band-limited levels.
+ */
+
+#define NAME "int"
+#define METH "fir"
+#define SYMB mixer_zz_fir
+#define DESC "polyphase windowed sinc (HQ)"
+
+#define ZZ_DBG_PREFIX "(mix-" METH  ") "
+#include "zz_private.h"
+
+#define PCMT int16_t			/* 16-bit levels */
+
+/* GB: Levels are copies of the instrument in 16-bit, the first one
+ *     as is and the others low-passed one more octave each (as for
+ *     the mip mixer, see mix_fir_levels()). A voice can read a full
+ *     kernel anywhere.
+ *
+ *     The kernel reads back FIR_PREV pcm. For looped instruments the
+ *     loop is moved as much forward so it never reads before the
+ *     loop start once looping. Non looped instruments have their
+ *     length extended for the kernel tail to ring out.
+ */
+#define MIXDATA fir_t fir;
+#define MIXPICK(P,M,K,C,T) fir_pick(&M->fir, K, C->note.ins-P->vset.inst, T)
+#define FREEMETH free_meth
+
+#define OPEPCM(OP) do {                                         \
+    zz_assert( pcm+(idx>>FP)+FIR_HALF+1 < K->end );             \
+    *b++ OP fir_pcm(pcm,idx);                                   \
+    idx += stp;                                                 \
+  } while (0)
+
+const int16_t fir_coef[FIR_PHASES][FIR_TAPS] = {
+#include "mix_fir.h"
+};
+
+struct mix_chan_s;
+static zz_err_t init_meth(core_t * P);
+static void free_meth(core_t * P);
+static void fir_pick(const fir_t *, struct mix_chan_s *,
+                     const int, const u8_t);
+
+#define SIMDRUN simd_fir		/* vector kernel */
+
+/* GB: The kernel is expensive enough for copying notes already
+ *     rendered to pay off (see mix_cache.c).
+ */
+#define NCACHE
+
+#include "mix_common.c"
+
+/* Pick the first level with a step not greater than 1. */
+static void
+fir_pick(const fir_t * const fir, mix_chan_t * const K, const int i,
+         const u8_t trig)
+{
+  u8_t l;
+
+  if (!fir->nlv[i]) {
+    K->pcm = 0;
+    return;
+  }
+  if (trig == TRIG_NOTE)
+    K->len += (u32_t) ( K->lpl ? FIR_PREV : FIR_HALF ) << FP;
+  for (l=0; l+1 < fir->nlv[i] && K->xtp > (1u<<FP)<<l; ++l)
+    ;
+  K->pcm = fir->lvl[i][l];
+  K->end = K->pcm + fir->end[i];
+}
+
+static zz_err_t init_meth(core_t * P)
+{
+  fir_t * const fir = &((mix_fp_t *)P->data)->fir;
+  int i;
+
+  for (i=0; i<P->vset.nbi; ++i)
+    if ( P->vset.inst[i].len && (P->song.iuse & (1l<<i)) )
+      /* Levels needed for the highest note played with it. */
+      fir->nlv[i] = !P->song.istep[i] ? 1 : mix_bands(
+        xstep((u32_t)P->song.istep[i] << 12, P->song.khz, P->spr));
+  return mix_fir_levels(fir, &P->vset);
+}
+
+static void free_meth(core_t * P)
+{
+  zz_free(&((mix_fp_t *)P->data)->fir.buf);
+}
@@ -0,0 +1,769 @@
+/* Generated by mix_fir.py -- do not edit */
+/* 000 */ {
+       1,     1,   -10,    30,   -62,    98,  -117,    89,
+      22,  -243,   581, -1010,  1475, -1895,  2188, 14089,
+    2188, -1895,  1475, -1010,   581,  -243,    22,    89,
+    -117,    98,   -62,    30,   -10,     1,     1,    -1
+},
+/* 001 */ {
+       1,     1,   -10,    31,   -62,    97,  -114,    84,
+      29,  -251,   588, -1011,  1461, -1853,  2073, 14087,
+    2304, -1936,  1487, -1009,   573,  -234,    15,    94,
+    -119,    99,   -62,    30,   -10,     1,     1,    -1
+},
+/* 002 */ {
+       1,     1,   -11,    31,   -62,    95,  -111,    79,
+      37,  -260,   595, -1011,  1448, -1811,  1959, 14084,
+    2421, -1976,  1499, -1007,   565,  -225,     7,    99,
+    -122,   100,   -62,    30,   -10,     1,     1,    -1
+},
+/* 003 */ {
+       1,     2,   -11,    31,   -62,    94,  -108,    74,
+      44,  -268,   601, -1011,  1433, -1768,  1845, 14080,
+    2539, -2016,  1511, -1005,   557,  -216,     0,   103,
+    -125,   100,   -62,    29,    -9,     1,     1,    -1
+},
+/* 004 */ {
+       1,     2,   -11,    31,   -62,    93,  -106,    69,
+      51,  -276,   607, -1011,  1419, -1726,  1732, 14076,
+    2658, -2056,  1521, -1002,   549,  -207,    -8,   108,
+    -127,   101,   -62,    29,    -9,     0,     1,    -1
+},
+/* 005 */ {
+       1,     2,   -11,    31,   -61,    92,  -103,    64,
+      58,  -284,   613, -1010,  1403, -1682,  1621, 14066,
+    2777, -2095,  1531,  -999,   540,  -198,   -15,   113,
+    -130,   102,   -62,    29,    -9,     0,     1,    -1
+},
+/* 006 */ {
+       1,     2,   -12,    32,   -61,    91,  -100,    59,
+      65,  -292,   619, -1009,  1387, -1638,  1510, 14051,
+    2898, -2133,  1541,  -995,   531,  -188,   -23,   118,
+    -132,   103,   -62,    28,    -8,     0,     2,    -1
+},
+/* 007 */ {
+       1,     2,   -12,    32,   -61,    90,   -97,    53,
+      72,  -299,   624, -1007,  1371, -1594,  1401, 14038,
+    3018, -2171,  1550,  -991,   522,  -179,   -30,   123,
+    -135,   104,   -62,    28,    -8,     0,     2,    -1
+},
+/* 008 */ {
+       0,     2,   -12,    32,   -61,    88,   -94,    48,
+      79,  -307,   629, -1005,  1354, -1550,  1292, 14024,
+    3140, -2208,  1558,  -986,   513,  -169,   -38,   128,
+    -137,   105,   -62,    28,    -8,     0,     2,    -1
+},
+/* 009 */ {
+       0,     3,   -12,    32,   -60,    87,   -91,    44,
+      86,  -314,   634, -1002,  1337, -1505,  1185, 14002,
+    3262, -2244,  1566,  -981,   503,  -159,   -46,   133,
+    -139,   105,   -62,    27,    -7,    -1,     2,    -1
+},
+/* 010 */ {
+       0,     3,   -13,    32,   -60,    86,   -88,    39,
+      92,  -321,   638,  -999,  1319, -1460,  1078, 13984,
+    3385, -2280,  1573,  -975,   493,  -149,   -53,   138,
+    -142,   106,   -62,    27,    -7,    -1,     2,    -1
+},
+/* 011 */ {
+       0,     3,   -13,    32,   -60,    84,   -85,    34,
+      99,  -328,   642,  -995,  1300, -1415,   973, 13965,
+    3509, -2315,  1579,  -969,   482,  -139,   -61,   142,
+    -144,   106,   -61,    26,    -7,    -1,     2,    -1
+},
+/* 012 */ {
+       0,     3,   -13,    32,   -59,    83,   -82,    29,
+     106,  -335,   646,  -991,  1281, -1369,   869, 13937,
+    3633, -2349,  1585,  -963,   472,  -129,   -69,   147,
+    -146,   107,   -61,    26,    -6,    -1,     2,    -1
+},
+/* 013 */ {
+       0,     3,   -13,    32,   -59,    81,   -79,    24,
+     112,  -341,   649,  -987,  1262, -1323,   766, 13914,
+    3758, -2383,  1589,  -956,   461,  -118,   -77,   152,
+    -148,   107,   -61,    25,    -6,    -1,     2,    -1
+},
+/* 014 */ {
+       0,     3,   -13,    32,   -58,    80,   -76,    19,
+     118,  -347,   653,  -982,  1242, -1277,   664, 13882,
+    3883, -2415,  1594,  -948,   450,  -108,   -84,   156,
+    -150,   108,   -61,    25,    -5,    -2,     2,    -1
+},
+/* 015 */ {
+       0,     3,   -13,    32,   -58,    78,   -73,    14,
+     125,  -353,   655,  -977,  1222, -1231,   563, 13854,
+    4009, -2447,  1597,  -940,   438,   -97,   -92,   161,
+    -152,   108,   -60,    24,    -5,    -2,     2,    -1
+},
+/* 016 */ {
+       0,     4,   -14,    33,   -57,    77,   -70,     9,
+     131,  -359,   658,  -971,  1202, -1185,   464, 13819,
+    4135, -2478,  1600,  -932,   426,   -87,  -100,   166,
+    -154,   109,   -60,    24,    -5,    -2,     2,    -1
+},
+/* 017 */ {
+       0,     4,   -14,    33,   -57,    75,   -67,     4,
+     137,  -365,   660,  -965,  1180, -1138,   366, 13788,
+    4261, -2509,  1602,  -923,   414,   -76,  -108,   170,
+    -156,   109,   -59,    23,    -4,    -2,     2,    -1
+},
+/* 018 */ {
+       0,     4,   -14,    32,   -56,    74,   -64,    -1,
+     143,  -370,   662,  -959,  1159, -1091,   268, 13750,
+    4388, -2538,  1604,  -913,   402,   -65,  -115,   174,
+    -158,   109,   -59,    23,    -4,    -2,     2,    -1
+},
+/* 019 */ {
+       0,     4,   -14,    32,   -56,    72,   -61,    -5,
+     149,  -376,   663,  -952,  1137, -1045,   173, 13713,
+    4516, -2567,  1604,  -903,   390,   -54,  -123,   179,
+    -160,   109,   -59,    22,    -3,    -3,     3,    -1
+},
+/* 020 */ {
+       0,     4,   -14,    32,   -55,    71,   -58,   -10,
+     155,  -381,   665,  -944,  1115,  -998,    78, 13669,
+    4644, -2594,  1604,  -893,   377,   -43,  -131,   183,
+    -162,   110,   -58,    22,    -3,    -3,     3,    -1
+},
+/* 021 */ {
+       0,     4,   -14,    32,   -55,    69,   -54,   -15,
+     160,  -386,   666,  -937,  1093,  -951,   -15, 13626,
+    4772, -2621,  1604,  -882,   364,   -32,  -139,   188,
+    -163,   110,   -57,    21,    -3,    -3,     3,    -1
+},
+/* 022 */ {
+       0,     4,   -14,    32,   -54,    67,   -51,   -20,
+     166,  -390,   666,  -929,  1070,  -904,  -107, 13583,
+    4900, -2647,  1602,  -871,   351,   -21,  -146,   192,
+    -165,   110,   -57,    20,    -2,    -3,     3,    -1
+},
+/* 023 */ {
+       0,     4,   -14,    32,   -53,    66,   -48,   -24,
+     171,  -395,   667,  -920,  1046,  -857,  -198, 13535,
+    5029, -2672,  1600,  -859,   337,    -9,  -154,   196,
+    -166,   110,   -56,    20,    -2,    -4,     3,    -1
+},
+/* 024 */ {
+      -1,     4,   -15,    32,   -53,    64,   -45,   -29,
+     177,  -399,   667,  -912,  1023,  -810,  -287, 13490,
+    5158, -2696,  1597,  -847,   324,     2,  -162,   200,
+    -168,   110,   -56,    19,    -1,    -4,     3,    -1
+},
+/* 025 */ {
+      -1,     5,   -15,    32,   -52,    62,   -42,   -33,
+     182,  -403,   666,  -903,   999,  -763,  -375, 13436,
+    5287, -2718,  1593,  -834,   310,    14,  -169,   204,
+    -169,   110,   -55,    19,    -1,    -4,     3,    -1
+},
+/* 026 */ {
+      -1,     5,   -15,    32,   -51,    61,   -39,   -38,
+     187,  -407,   666,  -893,   975,  -716,  -462, 13383,
+    5416, -2740,  1589,  -821,   296,    25,  -177,   208,
+    -171,   110,   -54,    18,     0,    -4,     3,    -1
+},
+/* 027 */ {
+      -1,     5,   -15,    32,   -51,    59,   -36,   -42,
+     192,  -411,   665,  -883,   950,  -669,  -547, 13333,
+    5545, -2761,  1584,  -808,   281,    37,  -184,   212,
+    -172,   109,   -54,    17,     0,    -5,     3,    -1
+},
+/* 028 */ {
+      -1,     5,   -15,    32,   -50,    57,   -33,   -47,
+     197,  -414,   664,  -873,   926,  -622,  -631, 13275,
+    5675, -2781,  1578,  -794,   267,    48,  -192,   216,
+    -173,   109,   -53,    16,     1,    -5,     3,    -1
+},
+/* 029 */ {
+      -1,     5,   -15,    31,   -49,    55,   -30,   -51,
+     202,  -418,   662,  -863,   901,  -576,  -713, 13219,
+    5804, -2800,  1571,  -779,   252,    60,  -199,   219,
+    -174,   109,   -52,    16,     1,    -5,     3,    -1
+},
+/* 030 */ {
+      -1,     5,   -15,    31,   -48,    54,   -26,   -56,
+     207,  -421,   661,  -852,   876,  -529,  -794, 13155,
+    5934, -2817,  1564,  -765,   237,    71,  -207,   223,
+    -175,   109,   -51,    15,     2,    -5,     3,    -1
+},
+/* 031 */ {
+      -1,     5,   -15,    31,   -48,    52,   -23,   -60,
+     211,  -424,   659,  -841,   850,  -483,  -874, 13095,
+    6064, -2834,  1555,  -749,   222,    83,  -214,   227,
+    -176,   108,   -50,    14,     2,    -5,     4,    -1
+},
+/* 032 */ {
+      -1,     5,   -15,    31,   -47,    50,   -20,   -64,
+     216,  -426,   656,  -829,   824,  -436,  -952, 13032,
+    6193, -2849,  1546,  -733,   207,    95,  -222,   230,
+    -177,   108,   -50,    13,     2,    -6,     4,    -1
+},
+/* 033 */ {
+      -1,     5,   -15,    31,   -46,    48,   -17,   -68,
+     220,  -429,   654,  -817,   799,  -390, -1029, 12964,
+    6323, -2863,  1537,  -717,   191,   106,  -229,   234,
+    -178,   107,   -49,    13,     3,    -6,     4,    -1
+},
+/* 034 */ {
+      -1,     5,   -15,    30,   -45,    46,   -14,   -72,
+     224,  -431,   651,  -805,   772,  -344, -1104, 12898,
+    6453, -2876,  1526,  -701,   176,   118,  -236,   237,
+    -179,   107,   -48,    12,     3,    -6,     4,    -1
+},
+/* 035 */ {
+      -1,     5,   -15,    30,   -44,    45,   -11,   -76,
+     228,  -433,   648,  -793,   746,  -299, -1178, 12828,
+    6582, -2888,  1515,  -684,   160,   130,  -243,   240,
+    -179,   106,   -47,    11,     4,    -6,     4,    -1
+},
+/* 036 */ {
+      -1,     5,   -15,    30,   -43,    43,    -8,   -80,
+     232,  -435,   644,  -780,   720,  -253, -1250, 12758,
+    6711, -2899,  1503,  -666,   144,   142,  -250,   243,
+    -180,   105,   -46,    10,     4,    -7,     4,    -1
+},
+/* 037 */ {
+      -1,     5,   -15,    29,   -43,    41,    -5,   -84,
+     236,  -436,   641,  -767,   693,  -208, -1321, 12686,
+    6840, -2908,  1490,  -648,   128,   153,  -257,   246,
+    -181,   105,   -45,     9,     5,    -7,     4,    -1
+},
+/* 038 */ {
+      -1,     5,   -15,    29,   -42,    39,    -2,   -88,
+     240,  -438,   637,  -754,   666,  -163, -1391, 12613,
+    6969, -2917,  1476,  -630,   112,   165,  -264,   249,
+    -181,   104,   -44,     9,     5,    -7,     4,    -1
+},
+/* 039 */ {
+      -1,     5,   -15,    29,   -41,    37,     1,   -92,
+     243,  -439,   632,  -741,   640,  -118, -1458, 12536,
+    7098, -2924,  1462,  -612,    95,   177,  -271,   252,
+    -181,   103,   -43,     8,     6,    -7,     4,    -1
+},
+/* 040 */ {
+      -1,     6,   -15,    29,   -40,    35,     4,   -96,
+     247,  -440,   628,  -727,   613,   -74, -1525, 12459,
+    7226, -2930,  1447,  -593,    79,   189,  -278,   255,
+    -182,   102,   -42,     7,     6,    -8,     4,    -1
+},
+/* 041 */ {
+      -1,     6,   -15,    28,   -39,    34,     7,   -99,
+     250,  -441,   623,  -713,   585,   -30, -1590, 12378,
+    7354, -2934,  1431,  -573,    62,   200,  -284,   258,
+    -182,   101,   -40,     6,     7,    -8,     4,    -1
+},
+/* 042 */ {
+      -1,     6,   -15,    28,   -38,    32,    10,  -103,
+     253,  -441,   618,  -699,   558,    14, -1653, 12296,
+    7482, -2937,  1415,  -553,    45,   212,  -291,   260,
+    -182,   100,   -39,     5,     7,    -8,     4,    -1
+},
+/* 043 */ {
+      -1,     6,   -15,    28,   -37,    30,    13,  -107,
+     256,  -442,   613,  -684,   531,    58, -1715, 12212,
+    7609, -2939,  1397,  -533,    28,   224,  -297,   263,
+    -182,    99,   -38,     4,     8,    -8,     4,    -1
+},
+/* 044 */ {
+      -1,     6,   -15,    27,   -36,    28,    15,  -110,
+     259,  -442,   607,  -670,   504,   101, -1775, 12131,
+    7736, -2940,  1379,  -513,    11,   235,  -304,   265,
+    -182,    98,   -37,     3,     8,    -8,     5,    -1
+},
+/* 045 */ {
+      -1,     6,   -15,    27,   -35,    26,    18,  -113,
+     262,  -442,   601,  -655,   476,   143, -1834, 12045,
+    7863, -2939,  1360,  -492,    -6,   247,  -310,   267,
+    -182,    97,   -36,     2,     9,    -9,     5,    -1
+},
+/* 046 */ {
+      -1,     6,   -15,    27,   -34,    24,    21,  -117,
+     264,  -442,   595,  -640,   449,   186, -1891, 11954,
+    7989, -2937,  1341,  -471,   -23,   258,  -316,   270,
+    -182,    96,   -34,     2,    10,    -9,     5,    -1
+},
+/* 047 */ {
+      -1,     6,   -15,    26,   -33,    23,    24,  -120,
+     267,  -441,   589,  -624,   421,   228, -1947, 11864,
+    8114, -2934,  1320,  -449,   -41,   270,  -322,   272,
+    -181,    95,   -33,     1,    10,    -9,     5,    -1
+},
+/* 048 */ {
+      -1,     6,   -14,    26,   -32,    21,    27,  -123,
+     269,  -440,   583,  -609,   394,   269, -2001, 11772,
+    8239, -2929,  1299,  -427,   -58,   281,  -328,   274,
+    -181,    93,   -32,     0,    11,    -9,     5,    -1
+},
+/* 049 */ {
+      -1,     6,   -14,    25,   -31,    19,    29,  -126,
+     271,  -440,   576,  -593,   366,   310, -2054, 11682,
+    8364, -2923,  1277,  -405,   -75,   293,  -334,   275,
+    -180,    92,   -30,    -1,    11,    -9,     5,    -1
+},
+/* 050 */ {
+      -1,     6,   -14,    25,   -30,    17,    32,  -129,
+     273,  -439,   569,  -577,   339,   351, -2105, 11589,
+    8488, -2915,  1255,  -383,   -93,   304,  -340,   277,
+    -180,    90,   -29,    -2,    12,   -10,     5,    -1
+},
+/* 051 */ {
+      -1,     6,   -14,    25,   -29,    15,    35,  -132,
+     275,  -437,   562,  -561,   311,   391, -2155, 11493,
+    8611, -2906,  1231,  -360,  -110,   315,  -345,   279,
+    -179,    89,   -28,    -3,    12,   -10,     5,    -1
+},
+/* 052 */ {
+      -1,     6,   -14,    24,   -28,    13,    37,  -135,
+     277,  -436,   555,  -545,   284,   430, -2203, 11399,
+    8734, -2896,  1207,  -337,  -128,   326,  -351,   280,
+    -179,    88,   -26,    -4,    13,   -10,     5,    -1
+},
+/* 053 */ {
+      -1,     6,   -14,    24,   -27,    12,    40,  -138,
+     279,  -434,   547,  -528,   256,   470, -2249, 11299,
+    8856, -2884,  1182,  -313,  -146,   337,  -356,   281,
+    -178,    86,   -25,    -5,    13,   -10,     5,    -1
+},
+/* 054 */ {
+      -1,     6,   -14,    23,   -26,    10,    42,  -141,
+     280,  -433,   539,  -512,   229,   508, -2294, 11204,
+    8977, -2871,  1157,  -290,  -163,   348,  -361,   283,
+    -177,    84,   -23,    -6,    14,   -11,     5,    -2
+},
+/* 055 */ {
+      -1,     6,   -14,    23,   -25,     8,    45,  -143,
+     282,  -431,   531,  -495,   202,   546, -2337, 11101,
+    9097, -2856,  1131,  -266,  -181,   359,  -366,   284,
+    -176,    83,   -22,    -7,    14,   -11,     5,    -2
+},
+/* 056 */ {
+      -1,     6,   -14,    22,   -24,     6,    47,  -146,
+     283,  -429,   523,  -478,   175,   584, -2379, 10999,
+    9217, -2840,  1104,  -241,  -199,   370,  -371,   285,
+    -175,    81,   -20,    -8,    15,   -11,     5,    -2
+},
+/* 057 */ {
+      -1,     6,   -13,    22,   -23,     4,    50,  -148,
+     284,  -426,   515,  -462,   147,   621, -2419, 10898,
+    9336, -2823,  1076,  -217,  -217,   380,  -376,   286,
+    -174,    79,   -19,    -9,    15,   -11,     5,    -2
+},
+/* 058 */ {
+      -1,     6,   -13,    22,   -22,     3,    52,  -150,
+     285,  -424,   506,  -445,   120,   657, -2458, 10791,
+    9454, -2804,  1048,  -192,  -234,   391,  -380,   286,
+    -172,    77,   -17,   -10,    16,   -11,     5,    -2
+},
+/* 059 */ {
+      -2,     6,   -13,    21,   -21,     1,    54,  -153,
+     286,  -421,   498,  -427,    93,   693, -2495, 10688,
+    9571, -2783,  1019,  -167,  -252,   401,  -385,   287,
+    -171,    76,   -16,   -11,    16,   -12,     5,    -2
+},
+/* 060 */ {
+      -2,     6,   -13,    21,   -20,    -1,    57,  -155,
+     287,  -418,   489,  -410,    67,   729, -2531, 10579,
+    9687, -2761,   989,  -142,  -270,   412,  -389,   287,
+    -170,    74,   -14,   -12,    17,   -12,     5,    -2
+},
+/* 061 */ {
+      -2,     6,   -13,    20,   -19,    -3,    59,  -157,
+     287,  -415,   480,  -393,    40,   763, -2565, 10475,
+    9802, -2738,   959,  -117,  -288,   422,  -393,   288,
+    -168,    72,   -13,   -13,    17,   -12,     5,    -2
+},
+/* 062 */ {
+      -2,     6,   -13,    20,   -18,    -4,    61,  -159,
+     288,  -412,   470,  -375,    14,   798, -2598, 10360,
+    9917, -2713,   928,   -91,  -305,   432,  -397,   288,
+    -166,    70,   -11,   -14,    18,   -12,     6,    -2
+},
+/* 063 */ {
+      -2,     6,   -13,    19,   -17,    -6,    63,  -161,
+     288,  -409,   461,  -358,   -13,   831, -2629, 10254,
+   10030, -2686,   896,   -65,  -323,   442,  -401,   288,
+    -165,    68,    -9,   -15,    18,   -12,     6,    -2
+},
+/* 064 */ {
+      -2,     6,   -12,    19,   -16,    -8,    66,  -163,
+     288,  -405,   451,  -340,   -39,   864, -2658, 10140,
+   10142, -2658,   864,   -39,  -340,   451,  -405,   288,
+    -163,    66,    -8,   -16,    19,   -12,     6,    -2
+},
+/* 065 */ {
+      -2,     6,   -12,    18,   -15,    -9,    68,  -165,
+     288,  -401,   442,  -323,   -65,   896, -2686, 10030,
+   10254, -2629,   831,   -13,  -358,   461,  -409,   288,
+    -161,    63,    -6,   -17,    19,   -13,     6,    -2
+},
+/* 066 */ {
+      -2,     6,   -12,    18,   -14,   -11,    70,  -166,
+     288,  -397,   432,  -305,   -91,   928, -2713,  9917,
+   10360, -2598,   798,    14,  -375,   470,  -412,   288,
+    -159,    61,    -4,   -18,    20,   -13,     6,    -2
+},
+/* 067 */ {
+      -2,     5,   -12,    17,   -13,   -13,    72,  -168,
+     288,  -393,   422,  -288,  -117,   959, -2738,  9802,
+   10475, -2565,   763,    40,  -393,   480,  -415,   287,
+    -157,    59,    -3,   -19,    20,   -13,     6,    -2
+},
+/* 068 */ {
+      -2,     5,   -12,    17,   -12,   -14,    74,  -170,
+     287,  -389,   412,  -270,  -142,   989, -2761,  9687,
+   10579, -2531,   729,    67,  -410,   489,  -418,   287,
+    -155,    57,    -1,   -20,    21,   -13,     6,    -2
+},
+/* 069 */ {
+      -2,     5,   -12,    16,   -11,   -16,    76,  -171,
+     287,  -385,   401,  -252,  -167,  1019, -2783,  9571,
+   10688, -2495,   693,    93,  -427,   498,  -421,   286,
+    -153,    54,     1,   -21,    21,   -13,     6,    -2
+},
+/* 070 */ {
+      -2,     5,   -11,    16,   -10,   -17,    77,  -172,
+     286,  -380,   391,  -234,  -192,  1048, -2804,  9454,
+   10791, -2458,   657,   120,  -445,   506,  -424,   285,
+    -150,    52,     3,   -22,    22,   -13,     6,    -1
+},
+/* 071 */ {
+      -2,     5,   -11,    15,    -9,   -19,    79,  -174,
+     286,  -376,   380,  -217,  -217,  1076, -2823,  9336,
+   10898, -2419,   621,   147,  -462,   515,  -426,   284,
+    -148,    50,     4,   -23,    22,   -13,     6,    -1
+},
+/* 072 */ {
+      -2,     5,   -11,    15,    -8,   -20,    81,  -175,
+     285,  -371,   370,  -199,  -241,  1104, -2840,  9217,
+   10999, -2379,   584,   175,  -478,   523,  -429,   283,
+    -146,    47,     6,   -24,    22,   -14,     6,    -1
+},
+/* 073 */ {
+      -2,     5,   -11,    14,    -7,   -22,    83,  -176,
+     284,  -366,   359,  -181,  -266,  1131, -2856,  9097,
+   11101, -2337,   546,   202,  -495,   531,  -431,   282,
+    -143,    45,     8,   -25,    23,   -14,     6,    -1
+},
+/* 074 */ {
+      -2,     5,   -11,    14,    -6,   -23,    84,  -177,
+     283,  -361,   348,  -163,  -290,  1157, -2871,  8977,
+   11204, -2294,   508,   229,  -512,   539,  -433,   280,
+    -141,    42,    10,   -26,    23,   -14,     6,    -1
+},
+/* 075 */ {
+      -1,     5,   -10,    13,    -5,   -25,    86,  -178,
+     281,  -356,   337,  -146,  -313,  1182, -2884,  8856,
+   11299, -2249,   470,   256,  -528,   547,  -434,   279,
+    -138,    40,    12,   -27,    24,   -14,     6,    -1
+},
+/* 076 */ {
+      -1,     5,   -10,    13,    -4,   -26,    88,  -179,
+     280,  -351,   326,  -128,  -337,  1207, -2896,  8734,
+   11399, -2203,   430,   284,  -545,   555,  -436,   277,
+    -135,    37,    13,   -28,    24,   -14,     6,    -1
+},
+/* 077 */ {
+      -1,     5,   -10,    12,    -3,   -28,    89,  -179,
+     279,  -345,   315,  -110,  -360,  1231, -2906,  8611,
+   11493, -2155,   391,   311,  -561,   562,  -437,   275,
+    -132,    35,    15,   -29,    25,   -14,     6,    -1
+},
+/* 078 */ {
+      -1,     5,   -10,    12,    -2,   -29,    90,  -180,
+     277,  -340,   304,   -93,  -383,  1255, -2915,  8488,
+   11589, -2105,   351,   339,  -577,   569,  -439,   273,
+    -129,    32,    17,   -30,    25,   -14,     6,    -1
+},
+/* 079 */ {
+      -1,     5,    -9,    11,    -1,   -30,    92,  -180,
+     275,  -334,   293,   -75,  -405,  1277, -2923,  8364,
+   11682, -2054,   310,   366,  -593,   576,  -440,   271,
+    -126,    29,    19,   -31,    25,   -14,     6,    -1
+},
+/* 080 */ {
+      -1,     5,    -9,    11,     0,   -32,    93,  -181,
+     274,  -328,   281,   -58,  -427,  1299, -2929,  8239,
+   11772, -2001,   269,   394,  -609,   583,  -440,   269,
+    -123,    27,    21,   -32,    26,   -14,     6,    -1
+},
+/* 081 */ {
+      -1,     5,    -9,    10,     1,   -33,    95,  -181,
+     272,  -322,   270,   -41,  -449,  1320, -2934,  8114,
+   11864, -1947,   228,   421,  -624,   589,  -441,   267,
+    -120,    24,    23,   -33,    26,   -15,     6,    -1
+},
+/* 082 */ {
+      -1,     5,    -9,    10,     2,   -34,    96,  -182,
+     270,  -316,   258,   -23,  -471,  1341, -2937,  7989,
+   11954, -1891,   186,   449,  -640,   595,  -442,   264,
+    -117,    21,    24,   -34,    27,   -15,     6,    -1
+},
+/* 083 */ {
+      -1,     5,    -9,     9,     2,   -36,    97,  -182,
+     267,  -310,   247,    -6,  -492,  1360, -2939,  7863,
+   12045, -1834,   143,   476,  -655,   601,  -442,   262,
+    -113,    18,    26,   -35,    27,   -15,     6,    -1
+},
+/* 084 */ {
+      -1,     5,    -8,     8,     3,   -37,    98,  -182,
+     265,  -304,   235,    11,  -513,  1379, -2940,  7736,
+   12131, -1775,   101,   504,  -670,   607,  -442,   259,
+    -110,    15,    28,   -36,    27,   -15,     6,    -1
+},
+/* 085 */ {
+      -1,     4,    -8,     8,     4,   -38,    99,  -182,
+     263,  -297,   224,    28,  -533,  1397, -2939,  7609,
+   12212, -1715,    58,   531,  -684,   613,  -442,   256,
+    -107,    13,    30,   -37,    28,   -15,     6,    -1
+},
+/* 086 */ {
+      -1,     4,    -8,     7,     5,   -39,   100,  -182,
+     260,  -291,   212,    45,  -553,  1415, -2937,  7482,
+   12296, -1653,    14,   558,  -699,   618,  -441,   253,
+    -103,    10,    32,   -38,    28,   -15,     6,    -1
+},
+/* 087 */ {
+      -1,     4,    -8,     7,     6,   -40,   101,  -182,
+     258,  -284,   200,    62,  -573,  1431, -2934,  7354,
+   12378, -1590,   -30,   585,  -713,   623,  -441,   250,
+     -99,     7,    34,   -39,    28,   -15,     6,    -1
+},
+/* 088 */ {
+      -1,     4,    -8,     6,     7,   -42,   102,  -182,
+     255,  -278,   189,    79,  -593,  1447, -2930,  7226,
+   12459, -1525,   -74,   613,  -727,   628,  -440,   247,
+     -96,     4,    35,   -40,    29,   -15,     6,    -1
+},
+/* 089 */ {
+      -1,     4,    -7,     6,     8,   -43,   103,  -181,
+     252,  -271,   177,    95,  -612,  1462, -2924,  7098,
+   12536, -1458,  -118,   640,  -741,   632,  -439,   243,
+     -92,     1,    37,   -41,    29,   -15,     5,    -1
+},
+/* 090 */ {
+      -1,     4,    -7,     5,     9,   -44,   104,  -181,
+     249,  -264,   165,   112,  -630,  1476, -2917,  6969,
+   12613, -1391,  -163,   666,  -754,   637,  -438,   240,
+     -88,    -2,    39,   -42,    29,   -15,     5,    -1
+},
+/* 091 */ {
+      -1,     4,    -7,     5,     9,   -45,   105,  -181,
+     246,  -257,   153,   128,  -648,  1490, -2908,  6840,
+   12686, -1321,  -208,   693,  -767,   641,  -436,   236,
+     -84,    -5,    41,   -43,    29,   -15,     5,    -1
+},
+/* 092 */ {
+      -1,     4,    -7,     4,    10,   -46,   105,  -180,
+     243,  -250,   142,   144,  -666,  1503, -2899,  6711,
+   12758, -1250,  -253,   720,  -780,   644,  -435,   232,
+     -80,    -8,    43,   -43,    30,   -15,     5,    -1
+},
+/* 093 */ {
+      -1,     4,    -6,     4,    11,   -47,   106,  -179,
+     240,  -243,   130,   160,  -684,  1515, -2888,  6582,
+   12828, -1178,  -299,   746,  -793,   648,  -433,   228,
+     -76,   -11,    45,   -44,    30,   -15,     5,    -1
+},
+/* 094 */ {
+      -1,     4,    -6,     3,    12,   -48,   107,  -179,
+     237,  -236,   118,   176,  -701,  1526, -2876,  6453,
+   12898, -1104,  -344,   772,  -805,   651,  -431,   224,
+     -72,   -14,    46,   -45,    30,   -15,     5,    -1
+},
+/* 095 */ {
+      -1,     4,    -6,     3,    13,   -49,   107,  -178,
+     234,  -229,   106,   191,  -717,  1537, -2863,  6323,
+   12964, -1029,  -390,   799,  -817,   654,  -429,   220,
+     -68,   -17,    48,   -46,    31,   -15,     5,    -1
+},
+/* 096 */ {
+      -1,     4,    -6,     2,    13,   -50,   108,  -177,
+     230,  -222,    95,   207,  -733,  1546, -2849,  6193,
+   13032,  -952,  -436,   824,  -829,   656,  -426,   216,
+     -64,   -20,    50,   -47,    31,   -15,     5,    -1
+},
+/* 097 */ {
+      -1,     4,    -5,     2,    14,   -50,   108,  -176,
+     227,  -214,    83,   222,  -749,  1555, -2834,  6064,
+   13095,  -874,  -483,   850,  -841,   659,  -424,   211,
+     -60,   -23,    52,   -48,    31,   -15,     5,    -1
+},
+/* 098 */ {
+      -1,     3,    -5,     2,    15,   -51,   109,  -175,
+     223,  -207,    71,   237,  -765,  1564, -2817,  5934,
+   13155,  -794,  -529,   876,  -852,   661,  -421,   207,
+     -56,   -26,    54,   -48,    31,   -15,     5,    -1
+},
+/* 099 */ {
+      -1,     3,    -5,     1,    16,   -52,   109,  -174,
+     219,  -199,    60,   252,  -779,  1571, -2800,  5804,
+   13219,  -713,  -576,   901,  -863,   662,  -418,   202,
+     -51,   -30,    55,   -49,    31,   -15,     5,    -1
+},
+/* 100 */ {
+      -1,     3,    -5,     1,    16,   -53,   109,  -173,
+     216,  -192,    48,   267,  -794,  1578, -2781,  5675,
+   13275,  -631,  -622,   926,  -873,   664,  -414,   197,
+     -47,   -33,    57,   -50,    32,   -15,     5,    -1
+},
+/* 101 */ {
+      -1,     3,    -5,     0,    17,   -54,   109,  -172,
+     212,  -184,    37,   281,  -808,  1584, -2761,  5545,
+   13333,  -547,  -669,   950,  -883,   665,  -411,   192,
+     -42,   -36,    59,   -51,    32,   -15,     5,    -1
+},
+/* 102 */ {
+      -1,     3,    -4,     0,    18,   -54,   110,  -171,
+     208,  -177,    25,   296,  -821,  1589, -2740,  5416,
+   13383,  -462,  -716,   975,  -893,   666,  -407,   187,
+     -38,   -39,    61,   -51,    32,   -15,     5,    -1
+},
+/* 103 */ {
+      -1,     3,    -4,    -1,    19,   -55,   110,  -169,
+     204,  -169,    14,   310,  -834,  1593, -2718,  5287,
+   13436,  -375,  -763,   999,  -903,   666,  -403,   182,
+     -33,   -42,    62,   -52,    32,   -15,     5,    -1
+},
+/* 104 */ {
+      -1,     3,    -4,    -1,    19,   -56,   110,  -168,
+     200,  -162,     2,   324,  -847,  1597, -2696,  5158,
+   13490,  -287,  -810,  1023,  -912,   667,  -399,   177,
+     -29,   -45,    64,   -53,    32,   -15,     4,    -1
+},
+/* 105 */ {
+      -1,     3,    -4,    -2,    20,   -56,   110,  -166,
+     196,  -154,    -9,   337,  -859,  1600, -2672,  5029,
+   13535,  -198,  -857,  1046,  -920,   667,  -395,   171,
+     -24,   -48,    66,   -53,    32,   -14,     4,     0
+},
+/* 106 */ {
+      -1,     3,    -3,    -2,    20,   -57,   110,  -165,
+     192,  -146,   -21,   351,  -871,  1602, -2647,  4900,
+   13583,  -107,  -904,  1070,  -929,   666,  -390,   166,
+     -20,   -51,    67,   -54,    32,   -14,     4,     0
+},
+/* 107 */ {
+      -1,     3,    -3,    -3,    21,   -57,   110,  -163,
+     188,  -139,   -32,   364,  -882,  1604, -2621,  4772,
+   13626,   -15,  -951,  1093,  -937,   666,  -386,   160,
+     -15,   -54,    69,   -55,    32,   -14,     4,     0
+},
+/* 108 */ {
+      -1,     3,    -3,    -3,    22,   -58,   110,  -162,
+     183,  -131,   -43,   377,  -893,  1604, -2594,  4644,
+   13669,    78,  -998,  1115,  -944,   665,  -381,   155,
+     -10,   -58,    71,   -55,    32,   -14,     4,     0
+},
+/* 109 */ {
+      -1,     3,    -3,    -3,    22,   -59,   109,  -160,
+     179,  -123,   -54,   390,  -903,  1604, -2567,  4516,
+   13713,   173, -1045,  1137,  -952,   663,  -376,   149,
+      -5,   -61,    72,   -56,    32,   -14,     4,     0
+},
+/* 110 */ {
+      -1,     2,    -2,    -4,    23,   -59,   109,  -158,
+     174,  -115,   -65,   402,  -913,  1604, -2538,  4388,
+   13750,   268, -1091,  1159,  -959,   662,  -370,   143,
+      -1,   -64,    74,   -56,    32,   -14,     4,     0
+},
+/* 111 */ {
+      -1,     2,    -2,    -4,    23,   -59,   109,  -156,
+     170,  -108,   -76,   414,  -923,  1602, -2509,  4261,
+   13788,   366, -1138,  1180,  -965,   660,  -365,   137,
+       4,   -67,    75,   -57,    33,   -14,     4,     0
+},
+/* 112 */ {
+      -1,     2,    -2,    -5,    24,   -60,   109,  -154,
+     166,  -100,   -87,   426,  -932,  1600, -2478,  4135,
+   13819,   464, -1185,  1202,  -971,   658,  -359,   131,
+       9,   -70,    77,   -57,    33,   -14,     4,     0
+},
+/* 113 */ {
+      -1,     2,    -2,    -5,    24,   -60,   108,  -152,
+     161,   -92,   -97,   438,  -940,  1597, -2447,  4009,
+   13854,   563, -1231,  1222,  -977,   655,  -353,   125,
+      14,   -73,    78,   -58,    32,   -13,     3,     0
+},
+/* 114 */ {
+      -1,     2,    -2,    -5,    25,   -61,   108,  -150,
+     156,   -84,  -108,   450,  -948,  1594, -2415,  3883,
+   13882,   664, -1277,  1242,  -982,   653,  -347,   118,
+      19,   -76,    80,   -58,    32,   -13,     3,     0
+},
+/* 115 */ {
+      -1,     2,    -1,    -6,    25,   -61,   107,  -148,
+     152,   -77,  -118,   461,  -956,  1589, -2383,  3758,
+   13914,   766, -1323,  1262,  -987,   649,  -341,   112,
+      24,   -79,    81,   -59,    32,   -13,     3,     0
+},
+/* 116 */ {
+      -1,     2,    -1,    -6,    26,   -61,   107,  -146,
+     147,   -69,  -129,   472,  -963,  1585, -2349,  3633,
+   13937,   869, -1369,  1281,  -991,   646,  -335,   106,
+      29,   -82,    83,   -59,    32,   -13,     3,     0
+},
+/* 117 */ {
+      -1,     2,    -1,    -7,    26,   -61,   106,  -144,
+     142,   -61,  -139,   482,  -969,  1579, -2315,  3509,
+   13965,   973, -1415,  1300,  -995,   642,  -328,    99,
+      34,   -85,    84,   -60,    32,   -13,     3,     0
+},
+/* 118 */ {
+      -1,     2,    -1,    -7,    27,   -62,   106,  -142,
+     138,   -53,  -149,   493,  -975,  1573, -2280,  3385,
+   13984,  1078, -1460,  1319,  -999,   638,  -321,    92,
+      39,   -88,    86,   -60,    32,   -13,     3,     0
+},
+/* 119 */ {
+      -1,     2,    -1,    -7,    27,   -62,   105,  -139,
+     133,   -46,  -159,   503,  -981,  1566, -2244,  3262,
+   14002,  1185, -1505,  1337, -1002,   634,  -314,    86,
+      44,   -91,    87,   -60,    32,   -12,     3,     0
+},
+/* 120 */ {
+      -1,     2,     0,    -8,    28,   -62,   105,  -137,
+     128,   -38,  -169,   513,  -986,  1558, -2208,  3140,
+   14024,  1292, -1550,  1354, -1005,   629,  -307,    79,
+      48,   -94,    88,   -61,    32,   -12,     2,     0
+},
+/* 121 */ {
+      -1,     2,     0,    -8,    28,   -62,   104,  -135,
+     123,   -30,  -179,   522,  -991,  1550, -2171,  3018,
+   14038,  1401, -1594,  1371, -1007,   624,  -299,    72,
+      53,   -97,    90,   -61,    32,   -12,     2,     1
+},
+/* 122 */ {
+      -1,     2,     0,    -8,    28,   -62,   103,  -132,
+     118,   -23,  -188,   531,  -995,  1541, -2133,  2898,
+   14051,  1510, -1638,  1387, -1009,   619,  -292,    65,
+      59,  -100,    91,   -61,    32,   -12,     2,     1
+},
+/* 123 */ {
+      -1,     1,     0,    -9,    29,   -62,   102,  -130,
+     113,   -15,  -198,   540,  -999,  1531, -2095,  2777,
+   14066,  1621, -1682,  1403, -1010,   613,  -284,    58,
+      64,  -103,    92,   -61,    31,   -11,     2,     1
+},
+/* 124 */ {
+      -1,     1,     0,    -9,    29,   -62,   101,  -127,
+     108,    -8,  -207,   549, -1002,  1521, -2056,  2658,
+   14076,  1732, -1726,  1419, -1011,   607,  -276,    51,
+      69,  -106,    93,   -62,    31,   -11,     2,     1
+},
+/* 125 */ {
+      -1,     1,     1,    -9,    29,   -62,   100,  -125,
+     103,     0,  -216,   557, -1005,  1511, -2016,  2539,
+   14080,  1845, -1768,  1433, -1011,   601,  -268,    44,
+      74,  -108,    94,   -62,    31,   -11,     2,     1
+},
+/* 126 */ {
+      -1,     1,     1,   -10,    30,   -62,   100,  -122,
+      99,     7,  -225,   565, -1007,  1499, -1976,  2421,
+   14084,  1959, -1811,  1448, -1011,   595,  -260,    37,
+      79,  -111,    95,   -62,    31,   -11,     1,     1
+},
+/* 127 */ {
+      -1,     1,     1,   -10,    30,   -62,    99,  -119,
+      94,    15,  -234,   573, -1009,  1487, -1936,  2304,
+   14087,  2073, -1853,  1461, -1011,   588,  -251,    29,
+      84,  -114,    97,   -62,    31,   -10,     1,     1
+}
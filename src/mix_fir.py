@@ -0,0 +1,45 @@
+#!/usr/bin/env python
+#
+# Compute zingzong int:fir polyphase windowed-sinc table (mix_fir.h).
+#
+# Kaiser windowed sinc; 32 taps, 128 phases, cutoff at .43 of the
+# source rate. Each phase is normalized to unity gain (Q14).
+#
+
+from __future__ import print_function
+import math
+
+TAPS, PHASES, ONE = 32, 128, 1 << 14
+FC, BETA = 0.43, 8.0
+
+def i0(x):
+    s = t = 1.0
+    for k in range(1, 40):
+        t *= (x / 2. / k) ** 2
+        s += t
+    return s
+
+def phase(p):
+    h, f = TAPS // 2, float(p) / PHASES
+    row = []
+    for t in range(TAPS):
+        x = (t - (h - 1)) - f
+        w = i0(BETA * math.sqrt(max(0., 1. - (x / h) ** 2))) / i0(BETA)
+        s = 2. * FC if x == 0 else math.sin(2. * math.pi * FC * x) / (math.pi * x)
+        row.append(s * w)
+    g = sum(row)
+    row = [int(round(v * ONE / g)) for v in row]
+    # put the rounding error on the largest tap
+    m = max(range(TAPS), key=lambda i: abs(row[i]))
+    row[m] += ONE - sum(row)
+    return row
+
+if __name__ == "__main__":
+    print("/* Generated by mix_fir.py -- do not edit */")
+    for p in range(PHASES):
+        row = phase(p)
+        print("/* %03u */ {" % p)
+        for i in range(0, TAPS, 8):
+            print("  " + ",".join("%6d" % v for v in row[i:i+8]) +
+                  ("," if i+8 < TAPS else ""))
+        print("}," if p+1 < PHASES else "}")
@@ -27,13 +27,21 @@ int16_t zz_i16_clip(i32_t v)
   return i16_clip(v);
 }
 
+/* clipped int32_t */
+static inline int32_t
+i32_clip(i64_t v)
+{
+  if ( unlikely(v < INT32_MIN) )
+    v = INT32_MIN;
+  else if ( unlikely(v > INT32_MAX) )
+    v = INT32_MAX;
+  return v;
+}
+
 #ifndef NO_FLOAT
 
 #include <math.h>
 
-/* int8_t to float sample conversion table */
-static float i8tofl_lut[256];
-
 /* Currently let the compiler do its work. */
 static inline i32_t
 fast_ftoi(const float f)
@@ -53,26 +61,30 @@ flt_to_i16(const float f)
   return i16_clip(fast_ftoi(f));
 }
 
+/* float to clipped int32_t */
+static inline int32_t
+flt_to_i32(const float f)
+{
+  if ( unlikely( !(f > -2147483648.0f) ) )
+    return INT32_MIN;                   /* NaN too */
+  if ( unlikely( f >= 2147483648.0f ) )
+    return INT32_MAX;
+  return (int32_t) f;
+}
+
 /* Convert int8_t PCM buffer to float PCM */
 void
 i8tofl(float * restrict d, const uint8_t * restrict s, int n)
 {
-  static int init = 0;
+  /* GB: No more lazily built table (not thread-safe). The conversion
+   *     is exact and vectorizes better anyway.
+   */
+  const float sc = 1.0 / 128.0;
 
-  if (unlikely(!init)) {
-    const float sc = 1.0 / 128.0;
-    int i; float * lut = i8tofl_lut;
-    init = 1;
-    for ( i = -128; i < 128; ++i ) {
-      *lut++ = sc * (float)i;
-      zz_assert( lut[-1] >= -1.0 );
-      zz_assert( lut[-1] <   1.0 );
-    }
-  }
   if (n > 0) {
     int i = 0;
     do {
-      d[i] = i8tofl_lut[s[i]];
+      d[i] = sc * (float) ( (int) s[i] - 128 );
     } while (++i<n);
   }
 }
@@ -92,8 +104,10 @@ map_flt_to_i16(int16_t * restrict d,
                const float * restrict vc, const float * restrict vd,
                const float sc1, const float sc2, const int n)
 {
-  int i;
-  for ( i=0; i<n; ++i ) {
+  int i = simd_map_flt(d, va, vb, vc, vd, sc1, sc2, n);
+
+  d += i << 1; va += i; vb += i; vc += i; vd += i;
+  for ( ; i<n; ++i ) {
     const float ab = *va ++ + *vb ++;
     const float cd = *vc ++ + *vd ++;
 
@@ -102,20 +116,491 @@ map_flt_to_i16(int16_t * restrict d,
   }
 }
 
+/* GB: The float mixers scale to 16-bit. Other formats rescale the
+ *     blending factors instead of the result.
+ */
+
+static void
+map_flt_to_i32(int32_t * restrict d,
+               const float * restrict va, const float * restrict vb,
+               const float * restrict vc, const float * restrict vd,
+               const float sc1, const float sc2, const int n)
+{
+  const float s1 = sc1 * 65536.0f, s2 = sc2 * 65536.0f;
+  int i;
+
+  for ( i=0; i<n; ++i ) {
+    const float ab = *va ++ + *vb ++;
+    const float cd = *vc ++ + *vd ++;
+
+    *d++ = flt_to_i32( ab * s1 + cd * s2 );
+    *d++ = flt_to_i32( ab * s2 + cd * s1 );
+  }
+}
+
+static void
+map_flt_to_f32(float * restrict d,
+               const float * restrict va, const float * restrict vb,
+               const float * restrict vc, const float * restrict vd,
+               const float sc1, const float sc2, const int n)
+{
+  const float s1 = sc1 / 32768.0f, s2 = sc2 / 32768.0f;
+  int i;
+
+  for ( i=0; i<n; ++i ) {
+    const float ab = *va ++ + *vb ++;
+    const float cd = *vc ++ + *vd ++;
+
+    *d++ = ab * s1 + cd * s2;
+    *d++ = ab * s2 + cd * s1;
+  }
+}
+
+void *
+map_flt_to_pcm(void * d, u8_t fmt,
+               const float * va, const float * vb,
+               const float * vc, const float * vd,
+               const float sc1, const float sc2, const int n)
+{
+  switch (fmt) {
+  case ZZ_PCM_I32:
+    map_flt_to_i32(d, va, vb, vc, vd, sc1, sc2, n);
+    break;
+  case ZZ_PCM_F32:
+    map_flt_to_f32(d, va, vb, vc, vd, sc1, sc2, n);
+    break;
+  default:
+    zz_assert( fmt == ZZ_PCM_I16 );
+    map_flt_to_i16(d, va, vb, vc, vd, sc1, sc2, n);
+  }
+  return (uint8_t *) d + n * ZZ_PCM_SIZE(fmt);
+}
+
+static void
+map_i16_to_f32(float * restrict d,
+               const int16_t * restrict va, const int16_t * restrict vb,
+               const int16_t * restrict vc, const int16_t * restrict vd,
+               const i16_t sc1, const i16_t sc2, const int n)
+{
+  const float sc = 1.0f / ( 512.0f * 32768.0f );
+  int i;
+
+  for ( i=0; i<n; ++i ) {
+    const i32_t ab = (i32_t) *va ++ + (i32_t) *vb ++;
+    const i32_t cd = (i32_t) *vc ++ + (i32_t) *vd ++;
+
+    *d++ = (float) (ab * sc1 + cd * sc2) * sc;
+    *d++ = (float) (ab * sc2 + cd * sc1) * sc;
+  }
+}
+
 #endif /* #ifndef NO_FLOAT */
 
-void
-map_i16_to_i16(int16_t * restrict d,
-               const i16_t * restrict va, const i16_t * restrict vb,
-               const i16_t * restrict vc, const i16_t * restrict vd,
+static void
+map_i16_to_i32(int32_t * restrict d,
+               const int16_t * restrict va, const int16_t * restrict vb,
+               const int16_t * restrict vc, const int16_t * restrict vd,
                const i16_t sc1, const i16_t sc2, const int n)
 {
   int i;
+
   for ( i=0; i<n; ++i ) {
     const i32_t ab = (i32_t) *va ++ + (i32_t) *vb ++;
     const i32_t cd = (i32_t) *vc ++ + (i32_t) *vd ++;
 
+    /* 9 more bits than the 16-bit version */
+    *d++ = i32_clip( (i64_t) (ab * sc1 + cd * sc2) * 128 );
+    *d++ = i32_clip( (i64_t) (ab * sc2 + cd * sc1) * 128 );
+  }
+}
+
+void *
+map_i16_to_pcm(void * d, u8_t fmt,
+               const int16_t * va, const int16_t * vb,
+               const int16_t * vc, const int16_t * vd,
+               const i16_t sc1, const i16_t sc2, const int n)
+{
+  switch (fmt) {
+  case ZZ_PCM_I32:
+    map_i16_to_i32(d, va, vb, vc, vd, sc1, sc2, n);
+    break;
+#ifndef NO_FLOAT
+  case ZZ_PCM_F32:
+    map_i16_to_f32(d, va, vb, vc, vd, sc1, sc2, n);
+    break;
+#endif
+  default:
+    zz_assert( fmt == ZZ_PCM_I16 );
+    map_i16_to_i16(d, va, vb, vc, vd, sc1, sc2, n);
+  }
+  return (uint8_t *) d + n * ZZ_PCM_SIZE(fmt);
+}
+
+void
+map_i16_to_i16(int16_t * restrict d,
+               const int16_t * restrict va, const int16_t * restrict vb,
+               const int16_t * restrict vc, const int16_t * restrict vd,
+               const i16_t sc1, const i16_t sc2, const int n)
+{
+  int i = simd_map_i16(d, va, vb, vc, vd, sc1, sc2, n);
+
+  d += i << 1; va += i; vb += i; vc += i; vd += i;
+  for ( ; i<n; ++i ) {
+    const i32_t ab = (i32_t) *va ++ + (i32_t) *vb ++;
+    const i32_t cd = (i32_t) *vc ++ + (i32_t) *vd ++;
+
     *d++ = i16_clip( (ab * sc1 + cd * sc2) >> 9 );
     *d++ = i16_clip( (ab * sc2 + cd * sc1) >> 9 );
   }
 }
+
+/* GB: The vector kernels saturate on their own so clipping is
+ *     counted on the output instead of in i16_clip(). Float output
+ *     is not clipped; samples beyond full scale are counted.
+ */
+u32_t
+mix_clips(const void * pcm, u8_t fmt, int n)
+{
+  u32_t cnt = 0;
+
+  n <<= 1;
+  switch (fmt) {
+  case ZZ_PCM_I32: {
+    const int32_t * s = pcm;
+    while (n--) {
+      const int32_t v = *s++;
+      cnt += v == INT32_MIN || v == INT32_MAX;
+    }
+  } break;
+#ifndef NO_FLOAT
+  case ZZ_PCM_F32: {
+    const float * s = pcm;
+    while (n--) {
+      const float v = *s++;
+      cnt += v >= 1.0f || v <= -1.0f;
+    }
+  } break;
+#endif
+  default: {
+    const int16_t * s = pcm;
+    while (n--) {
+      const int16_t v = *s++;
+      cnt += v == -32768 || v == 32767;
+    }
+  }
+  }
+  return cnt;
+}
+
+/* ----------------------------------------------------------------------
+ * Band-limited levels
+ * ---------------------------------------------------------------------- */
+
+/* Half-band low-pass (odd taps; -6dB at 1/4, -67dB at 0.35). */
+static const int16_t hb_tap[] = {
+  5142, -1531, 728, -360, 164, -62, 16
+};
+#define HB_TAPS ( sizeof(hb_tap) / sizeof(*hb_tap) )
+#define HB_MID  8190			/* center tap */
+#define HB_ONE  14			/* coefficients scale */
+
+/* Neighbour m of n; silence before the start and loop continues
+ * after the end. Once in the loop it is periodic both ways. */
+static i32_t
+band_at(const int32_t * const x, i32_t m, const i32_t n,
+        const i32_t len, const i32_t lpl)
+{
+  const i32_t off = len - lpl;
+
+  if (m >= len) {
+    if (!lpl)
+      return 0;
+    m = off + (m - off) % lpl;
+  } else if (lpl && n >= off && m < off)
+    m = off + (lpl - (off - m) % lpl) % lpl;
+  else if (m < 0)
+    return 0;
+  return x[m];
+}
+
+void
+mix_halfband(int32_t * restrict y, const int32_t * restrict x,
+             const i32_t d, const i32_t len, const i32_t lpl)
+{
+  const i32_t span = d * (2*HB_TAPS-1);
+  i32_t n;
+
+  for (n=0; n<len; ++n) {
+    const i32_t lo = lpl && n >= len-lpl ? len-lpl : 0;
+    i32_t v = HB_MID * x[n] + (1 << (HB_ONE-1));
+    u8_t j;
+
+    if (n-span >= lo && n+span < len)
+      for (j=0; j<HB_TAPS; ++j) {
+        const i32_t o = d * (2*j+1);
+        v += hb_tap[j] * ( x[n-o] + x[n+o] );
+      }
+    else
+      for (j=0; j<HB_TAPS; ++j) {
+        const i32_t o = d * (2*j+1);
+        v += hb_tap[j] * ( band_at(x, n-o, n, len, lpl) +
+                           band_at(x, n+o, n, len, lpl) );
+      }
+    v >>= HB_ONE;
+    y[n] = v < -0x8000 ? -0x8000 : v > 0x7FFF ? 0x7FFF : v;
+  }
+}
+
+u8_t
+mix_bands(const u32_t xtp)
+{
+  u8_t n;
+
+  for (n=1; n < MIX_BANDS && xtp > (1u<<FP) << (n-1); ++n)
+    ;
+  return n;
+}
+
+static void
+fir_level(int16_t * const pcm, const int32_t * const x,
+          const i32_t len, const i32_t lpl)
+{
+  i32_t n;
+
+  for (n=-FIR_PREV; n<0; ++n)
+    pcm[n] = 0;
+  for (n=0; n<len; ++n)
+    pcm[n] = x[n];
+  for ( ; n<len+FIR_NEXT; ++n)
+    pcm[n] = lpl ? pcm[n-lpl] : 0;
+}
+
+zz_err_t
+mix_fir_levels(fir_t * const fir, const vset_t * const vset)
+{
+  int32_t * tmp = 0;
+  int16_t * buf;
+  u32_t tot = 0, max = 0;
+  zz_err_t ecode;
+  int i;
+
+  for (i=0; i<vset->nbi; ++i) {
+    const i32_t len = vset->inst[i].len;
+
+    if (!fir->nlv[i])
+      continue;
+    fir->end[i] = len + FIR_NEXT;
+    tot += mulu32(fir->nlv[i], FIR_PREV + fir->end[i]);
+    if (len > max)
+      max = len;
+  }
+
+  dmsg("levels: %lu bytes\n", LU(tot*sizeof(*buf)));
+  if (!tot)
+    return E_OK;
+
+  if ( (ecode = zz_malloc(&fir->buf, tot*sizeof(*buf))) ||
+       (ecode = zz_malloc(&tmp, max*2*sizeof(*tmp))) )
+    return ecode;
+
+  for (i=0, buf=fir->buf; i<vset->nbi; ++i) {
+    const inst_t * const inst = vset->inst+i;
+    const i32_t len = inst->len;
+    const i32_t lpl = inst->lpl;
+    int32_t * x = tmp, * y = tmp+max, * t;
+    i32_t n;
+    u8_t l;
+
+    if (!fir->nlv[i])
+      continue;
+    for (n=0; n<len; ++n)
+      x[n] = ( inst->pcm[n] - 128 ) << 8;
+    for (l=0; l<fir->nlv[i]; ++l) {
+      if (l) {
+        mix_halfband(y, x, 1 << (l-1), len, lpl);
+        t = x; x = y; y = t;
+      }
+      buf += FIR_PREV;
+      fir_level(buf, x, len, lpl);
+      fir->lvl[i][l] = buf;
+      buf += fir->end[i];
+    }
+    dmsg("I#%02hu: %hu levels\n", HU(i), HU(fir->nlv[i]));
+  }
+  zz_assert( buf == fir->buf+tot );
+  zz_free(&tmp);
+
+  return E_OK;
+}
+
+/* ----------------------------------------------------------------------
+ * Voice set preparation
+ * ---------------------------------------------------------------------- */
+
+zz_err_t
+mix_prep_lerp(vset_t * const vset)
+{
+  const uint8_t * end = vset->bin->ptr+vset->bin->max;
+  int i;
+
+  for (i=0; i<vset->nbi; ++i) {
+    inst_t * const inst = vset->inst+i;
+    const i32_t len = inst->len;
+    const i32_t lpl = inst->lpl;
+
+    if (len) {
+      inst->end = len+1;		/* lerp needs 1 additional PCM */
+      if (inst->pcm+inst->end > end) {
+        emsg("lerp: I#%02hu out of range\n",HU(i));
+        return E_MIX;
+      }
+      inst->pcm[len] = !lpl ? 128 : inst->pcm[len-lpl];
+    }
+  }
+  return E_OK;
+}
+
+/* ----------------------------------------------------------------------
+ * Voice workers
+ * ---------------------------------------------------------------------- */
+
+#ifndef NO_THREAD
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <errno.h>
+
+typedef struct pool_wrk_s pool_wrk_t;
+
+struct pool_wrk_s {
+  mix_pool_t * pool;			/* owner */
+  pthread_t    tid;			/* thread */
+  sem_t	       go;			/* run request */
+  int8_t       k;			/* voice number */
+  int8_t       ok;			/* thread is running */
+};
+
+struct mix_pool_s {
+  mix_job_t  job;			/* per voice job */
+  void      *user;			/* job cookie */
+  int	     n;				/* pcm for this run */
+  int	     quit;			/* workers should exit */
+  int	     err;			/* ORed job results */
+  sem_t	     done;			/* one post per finished voice */
+  int8_t     ok;			/* done semaphore is valid */
+  pool_wrk_t wrk[3];			/* voice 3 is the caller's */
+};
+
+static void
+pool_wait(sem_t * sem)
+{
+  while (sem_wait(sem) && errno == EINTR)
+    ;
+}
+
+static void *
+pool_thread(void * arg)
+{
+  pool_wrk_t * const W = arg;
+  mix_pool_t * const pool = W->pool;
+
+  for (;;) {
+    pool_wait(&W->go);
+    if (zz_atomic_get(&pool->quit))
+      break;
+    if (pool->job(pool->user, W->k, pool->n))
+      zz_atomic_set(&pool->err, -1);
+    /* GB: Releases the voice buffer to the caller. */
+    sem_post(&pool->done);
+  }
+  return 0;
+}
+
+void
+mix_pool_del(mix_pool_t ** ppool)
+{
+  mix_pool_t * const pool = *ppool;
+
+  if (pool) {
+    int k;
+    zz_atomic_set(&pool->quit, 1);
+    for (k=0; k<3; ++k) {
+      pool_wrk_t * const W = pool->wrk+k;
+      if (W->ok) {
+        sem_post(&W->go);
+        pthread_join(W->tid, 0);
+      }
+      if (W->ok >= 0)
+        sem_destroy(&W->go);
+    }
+    if (pool->ok)
+      sem_destroy(&pool->done);
+    zz_free(ppool);
+  }
+}
+
+zz_err_t
+mix_pool_new(mix_pool_t ** ppool, mix_job_t job, void * user)
+{
+  mix_pool_t * pool;
+  zz_err_t ecode;
+  int k, err = 0;
+
+  zz_assert( ppool );
+  zz_assert( job );
+
+  ecode = zz_calloc(ppool, sizeof(mix_pool_t));
+  if (ecode)
+    return ecode;
+  pool = *ppool;
+  pool->job  = job;
+  pool->user = user;
+  for (k=0; k<3; ++k)
+    pool->wrk[k].ok = -1;		/* no semaphore */
+
+  if (sem_init(&pool->done, 0, 0))
+    err = errno;
+  pool->ok = !err;
+
+  for (k=0; !err && k<3; ++k) {
+    pool_wrk_t * const W = pool->wrk+k;
+    W->pool = pool;
+    W->k    = k;
+    if (sem_init(&W->go, 0, 0)) {
+      err = errno;
+      break;
+    }
+    W->ok = 0;
+    err = pthread_create(&W->tid, 0, pool_thread, W);
+    W->ok = !err;
+  }
+
+  if (err) {
+    wmsg("voice workers: (%d) %s\n", err, strerror(err));
+    mix_pool_del(ppool);
+    return E_SYS;
+  }
+  dmsg("voice workers: ready\n");
+  return E_OK;
+}
+
+int
+mix_pool_run(mix_pool_t * pool, int n)
+{
+  int k, err;
+
+  pool->n   = n;
+  pool->err = 0;
+  for (k=0; k<3; ++k)
+    sem_post(&pool->wrk[k].go);
+
+  err = pool->job(pool->user, 3, n);
+
+  /* The others voices should be about done. */
+  for (k=0; k<3; ++k)
+    pool_wait(&pool->done);
+
+  return err | pool->err;
+}
+
+#endif /* NO_THREAD */
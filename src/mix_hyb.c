@@ -0,0 +1,153 @@
+/**
+ * @file   mix_hyb.c
+ * @author Benjamin Gerard AKA Ben/OVR
+ * @date   2026-10-16
+ * @brief  Per voice copy, linear or windowed sinc resampling.
+ */
+
+#define NAME "int"
+#define METH "hyb"
+#define SYMB mixer_zz_hyb
+#define DESC "per voice copy, lerp or windowed sinc (fast,HQ)"
+
+#define ZZ_DBG_PREFIX "(mix-" METH  ") "
+#include "zz_private.h"
+
+#define PCMT int16_t			/* 16-bit levels */
+
+/* GB: Only voices played slower than the output rate need the
+ *     band-limited kernel. Each voice picks its method whenever its
+ *     step changes (note or slide):
+ *
+ *     - step exactly 1: the level is copied as is.
+ *     - step below 1: linear interpolation, images of an up-sampled
+ *       voice are mostly above what was in the instrument.
+ *     - step above 1: int:fir kernel on the band-limited levels.
+ *
+ *     All methods read the int:fir levels so a voice can switch in
+ *     the middle of a slide.
+ */
+enum {
+  HYB_COPY, HYB_LERP, HYB_SINC
+};
+
+#define MIXDATA fir_t fir;
+#define CHANDATA u8_t mode;
+#define MIXPICK(P,M,K,C,T) hyb_pick(&M->fir, K, C->note.ins-P->vset.inst, T)
+#define MIXRUN hyb_run
+#define FREEMETH free_meth
+#define PUSHCB push_hyb
+#define MIXSTATS "copy pcm", "lerp pcm", "sinc pcm",
+
+struct mix_chan_s;
+static zz_err_t init_meth(core_t * P);
+static void free_meth(core_t * P);
+static void hyb_pick(const fir_t *, struct mix_chan_s *,
+                     const int, const u8_t);
+static inline u32_t hyb_run(struct mix_chan_s *, int16_t *, u32_t, int);
+static i16_t push_hyb(core_t * P, void * pcm, i16_t N);
+
+/* GB: Copying notes already rendered pays off for the sinc ones
+ *     (see mix_cache.c).
+ */
+#define NCACHE
+
+#include "mix_common.c"
+
+static inline u32_t
+hyb_run(mix_chan_t * const restrict K, int16_t * restrict b,
+        u32_t idx, int n)
+{
+  const int16_t * const pcm = K->pcm;
+  const u32_t stp = K->xtp;
+  int k;
+
+  switch (K->mode) {
+  case HYB_COPY:
+    zz_assert( stp == 1u << FP );
+    zz_memcpy(b, pcm + (idx >> FP), n * sizeof(*b));
+    return idx + ( (u32_t) n << FP );
+
+  case HYB_LERP:
+    for (k=0; k<n; ++k, idx += stp) {
+      const int16_t * const p = pcm + (idx >> FP);
+      const i32_t f = ( idx & ( (1u << FP) - 1u ) ) >> 1;
+      b[k] = p[0] + ( ( ( p[1] - p[0] ) * f ) >> ( FP - 1 ) );
+    }
+    return idx;
+
+  default:
+    k = simd_fir(b, pcm, idx, stp, n, K->end - K->pcm);
+    for (idx += k*stp; k<n; ++k, idx += stp)
+      b[k] = fir_pcm(pcm, idx);
+    return idx;
+  }
+}
+
+/* Pick the method and the first level with a step not greater
+ * than 1. */
+static void
+hyb_pick(const fir_t * const fir, mix_chan_t * const K, const int i,
+         const u8_t trig)
+{
+  u8_t l;
+
+  if (!fir->nlv[i]) {
+    K->pcm = 0;
+    return;
+  }
+  if (trig == TRIG_NOTE)
+    K->len += (u32_t) ( K->lpl ? FIR_PREV : FIR_HALF ) << FP;
+  K->mode = K->xtp == 1u << FP ? HYB_COPY
+    : K->xtp < 1u << FP ? HYB_LERP
+    : HYB_SINC;
+  for (l=0; l+1 < fir->nlv[i] && K->xtp > (1u<<FP)<<l; ++l)
+    ;
+  K->pcm = fir->lvl[i][l];
+  K->end = K->pcm + fir->end[i];
+}
+
+static i16_t
+push_hyb(core_t * const P, void * restrict pcm, i16_t N)
+{
+  mix_fp_t * const M = (mix_fp_t *)P->data;
+  int k;
+  STATS_START(P,t);
+
+  zz_assert( P );
+  zz_assert( M );
+  zz_assert( pcm );
+  zz_assert( N > 0 );
+
+  if (mix_trig(P, M))
+    return -1;
+
+  /* Voice pcm per method (as of the start of the push). */
+  if (STATS_ON(P))
+    for (k=0; k<4; ++k)
+      if (M->chan[k].pcm)
+        STATS_MIX(P,STAT_MIX+M->chan[k].mode,N);
+  STATS_STAGE(P,trig,t,1);
+
+  mix_voices(P, M, pcm, P->pcmfmt, N);
+  STATS_ADD(P,clips,mix_clips(pcm, P->pcmfmt, N));
+
+  return N;
+}
+
+static zz_err_t init_meth(core_t * P)
+{
+  fir_t * const fir = &((mix_fp_t *)P->data)->fir;
+  int i;
+
+  for (i=0; i<P->vset.nbi; ++i)
+    if ( P->vset.inst[i].len && (P->song.iuse & (1l<<i)) )
+      fir->nlv[i] = !P->song.istep[i] ? 1 : mix_bands(
+        xstep((u32_t)P->song.istep[i] << 12, P->song.khz, P->spr));
+  return mix_fir_levels(fir, &P->vset);
+}
+
+static void free_meth(core_t * P)
+{
+  zz_free(&((mix_fp_t *)P->data)->fir.buf);
+}
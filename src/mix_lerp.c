@@ -32,27 +32,15 @@ static inline i16_t lerp(const uint8_t * const pcm, u32_t idx)
   return r;
 }
 
+/* GB: Players using lerp (or mip) share the same prepared voice set.
+ */
 static zz_err_t init_meth(core_t * P)
 {
-  const uint8_t * end = (uint8_t *)P->vset.bin->ptr+P->vset.bin->max;
-  int i;
-
-  for (i=0; i<P->vset.nbi; ++i) {
-    const i32_t len = P->vset.inst[i].len;
-    const i32_t lpl = P->vset.inst[i].lpl;
-
-    if (len) {
-      uint8_t * const pcm = P->vset.inst[i].pcm;
-      P->vset.inst[i].end = len+1;   /* lerp needs 1 additional PCM */
-      if (pcm+P->vset.inst[i].end > end) {
-        emsg(METH ": I#%02hu out of range\n",HU(i));
-        return E_MIX;
-      }
-
-      pcm[len] = !lpl ? 128 : pcm[len-lpl];
-    }
-  }
-  return ZZ_OK;
+  return vset_prepare(&P->vset, mix_prep_lerp);
 }
 
+#define SIMDRUN simd_lerp		/* vector kernel */
+#define FUSERUN simd_fuse_lerp	/* fused vector kernel */
+#define GETPCM(PCM,IDX) lerp(PCM,IDX)
+
 #include "mix_common.c"
@@ -0,0 +1,162 @@
+/**
+ * @file   mix_mip.c
+ * @author Benjamin Gerard AKA Ben/OVR
+ * @date   2026-10-16
+ * @brief  Band-limited mipmap with linear interpolation.
+ */
+
+#define NAME "int"
+#define METH "mip"
+#define SYMB mixer_zz_mip
+#define DESC "band-limited mipmap (fast,HQ)"
+
+#define ZZ_DBG_PREFIX "(mix-" METH  ") "
+#include "zz_private.h"
+
+/* GB: Each level is a full length copy of the instrument low-passed
+ *     one more octave than the previous one. Indices and loops are
+ *     the same for all levels so a voice only changes its pcm
+ *     pointer to switch level.
+ */
+typedef struct mip_s mip_t;
+struct mip_s {
+  uint8_t * buf;			/* levels storage (1..) */
+  uint8_t * lvl[20][MIX_BANDS];		/* level pcm per instrument */
+  uint8_t   nlv[20];			/* number of level (0:n/a) */
+};
+
+#define MIXDATA  mip_t mip;
+#define MIXPICK(P,M,K,C,T) mip_pick(&M->mip, K, C->note.ins-P->vset.inst)
+#define FREEMETH free_meth
+
+#define OPEPCM(OP) do {                         \
+    zz_assert( pcm+(idx>>FP)+0 < K->end );      \
+    zz_assert( pcm+(idx>>FP)+1 < K->end );      \
+    *b++ OP lerp(pcm,idx);                      \
+    idx += stp;                                 \
+  } while (0)
+
+/* Linear Interpolation (same as mix_lerp.c).
+ */
+static inline i16_t lerp(const uint8_t * const pcm, u32_t idx)
+{
+  const i32_t i = idx >> FP;
+  const i16_t a = pcm[i+0]-128;           /* f(0) */
+  const i16_t b = pcm[i+1]-128;           /* f(1) */
+  const i16_t j = idx & ((1<<FP)-1);
+  const i16_t r = ( (b * j) + (a * ((1<<FP)-j)) ) >> ( FP - 8 );
+  return r;
+}
+
+struct mix_chan_s;
+static zz_err_t init_meth(core_t * P);
+static void free_meth(core_t * P);
+static void mip_pick(const mip_t *, struct mix_chan_s *, const int);
+
+#define SIMDRUN simd_lerp		/* vector kernel */
+#define FUSERUN simd_fuse_lerp	/* fused vector kernel */
+#define GETPCM(PCM,IDX) lerp(PCM,IDX)
+
+#include "mix_common.c"
+
+/* Pick the first level with a step not greater than 1. */
+static void
+mip_pick(const mip_t * const mip, mix_chan_t * const K, const int i)
+{
+  uint8_t * const * const lvl = mip->lvl[i];
+  u8_t l;
+
+  for (l=0; l+1 < mip->nlv[i] && K->xtp > (1u<<FP)<<l; ++l)
+    ;
+  if (lvl[l] && lvl[l] != K->pcm) {
+    K->end = lvl[l] + (K->end - K->pcm);
+    K->pcm = lvl[l];
+  }
+}
+
+static void
+mip_level(uint8_t * const pcm, const int32_t * const x,
+          const i32_t len, const i32_t lpl)
+{
+  i32_t n;
+
+  for (n=0; n<len; ++n) {
+    const i32_t v = ( x[n] + 0x80 ) >> 8;
+    pcm[n] = 128 + ( v < -128 ? -128 : v > 127 ? 127 : v );
+  }
+  pcm[len] = !lpl ? 128 : pcm[len-lpl];
+}
+
+static zz_err_t init_meth(core_t * P)
+{
+  mip_t * const mip = &((mix_fp_t *)P->data)->mip;
+  int32_t * tmp = 0;
+  uint8_t * buf;
+  u32_t tot = 0, max = 0;
+  zz_err_t ecode;
+  int i;
+
+  /* Level #0 is the instrument itself (as for lerp). */
+  if ( (ecode = vset_prepare(&P->vset, mix_prep_lerp)) )
+    return ecode;
+
+  for (i=0; i<P->vset.nbi; ++i) {
+    const inst_t * const inst = P->vset.inst+i;
+    const i32_t len = inst->len;
+    u32_t xtp;
+
+    if (!len)
+      continue;
+
+    mip->lvl[i][0] = inst->pcm;
+    mip->nlv[i] = 1;
+
+    /* Levels needed for the highest note played with it. */
+    if ( ! (P->song.iuse & (1l<<i)) || !P->song.istep[i] )
+      continue;
+    xtp = xstep((u32_t)P->song.istep[i] << 12, P->song.khz, P->spr);
+    mip->nlv[i] = mix_bands(xtp);
+    tot += mulu32(mip->nlv[i]-1, len+1);
+    if (mip->nlv[i] > 1 && len > max)
+      max = len;
+  }
+
+  dmsg("levels: %lu bytes\n", LU(tot));
+  if (!tot)
+    return E_OK;
+
+  if ( (ecode = zz_malloc(&mip->buf, tot)) ||
+       (ecode = zz_malloc(&tmp, max*2*sizeof(*tmp))) )
+    return ecode;
+
+  for (i=0, buf=mip->buf; i<P->vset.nbi; ++i) {
+    const inst_t * const inst = P->vset.inst+i;
+    const i32_t len = inst->len;
+    const i32_t lpl = inst->lpl;
+    int32_t * x = tmp, * y = tmp+max, * t;
+    i32_t n;
+    u8_t l;
+
+    if (mip->nlv[i] < 2)
+      continue;
+    for (n=0; n<len; ++n)
+      x[n] = ( inst->pcm[n] - 128 ) << 8;
+    for (l=1; l<mip->nlv[i]; ++l) {
+      mix_halfband(y, x, 1 << (l-1), len, lpl);
+      mip_level(buf, y, len, lpl);
+      mip->lvl[i][l] = buf;
+      buf += len+1;
+      t = x; x = y; y = t;
+    }
+    dmsg("I#%02hu: %hu levels\n", HU(i), HU(mip->nlv[i]));
+  }
+  zz_assert( buf == mip->buf+tot );
+  zz_free(&tmp);
+
+  return E_OK;
+}
+
+static void free_meth(core_t * P)
+{
+  zz_free(&((mix_fp_t *)P->data)->mip.buf);
+}
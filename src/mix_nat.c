@@ -0,0 +1,206 @@
+/**
+ * @file   mix_nat.c
+ * @author Benjamin Gerard AKA Ben/OVR
+ * @date   2026-10-16
+ * @brief  Mix at the song rate then resample the stereo mix.
+ */
+
+#define NAME "int"
+#define METH "nat"
+#define SYMB mixer_zz_nat
+#define DESC "native rate mix then windowed sinc (fast,HQ)"
+
+#define ZZ_DBG_PREFIX "(mix-" METH  ") "
+#include "zz_private.h"
+
+/* GB: Voices play at the song rate (4 to 20 kHz) with no
+ *     interpolation. Notes step over the pcm exactly as the original
+ *     replay did. The stereo mix is converted once to the output
+ *     rate by the int:fir kernel running at a fixed ratio, that is
+ *     two sinc streams instead of one per voice.
+ *
+ *     The converter position is kept as an exact fraction (frac/spr
+ *     of a native pcm). Only the pcm needed by the output of a push
+ *     are mixed, the kernel needs FIR_HALF+2 pcm ahead. So does the
+ *     whole mix lag by as much (under 5ms at 4 kHz) as with any sinc
+ *     converter.
+ *
+ *     There is nothing to gain when the output rate is not above
+ *     the song rate; the voices are then mixed directly at the
+ *     output rate (as int:none).
+ */
+#define NAT_MAX (FIR_PREV+64+FIR_HALF+2+1) /* native pcm history */
+
+typedef struct nat_s nat_t;
+struct nat_s {
+  u32_t	  spr;				/* voices sampling rate */
+  u32_t	  pos;				/* converter pcm (in buf) */
+  u32_t	  frac;				/* converter fraction (/spr) */
+  u32_t	  ofs;				/* output pcm since pos,frac */
+  u32_t	  cnt;				/* native pcm in buf */
+  int16_t buf[2][NAT_MAX];		/* native pcm (left,right) */
+};
+
+#define MIXDATA nat_t nat;
+#define MIXSAVE nat
+#define VOXSPR(P,M) (M)->nat.spr
+#define PUSHCB push_nat
+#define SKIPCB skip_nat
+
+#define OPEPCM(OP) do {                         \
+    zz_assert( &pcm[idx>>FP] < K->end );        \
+    *b++ OP ( ( pcm[idx>>FP]-128 ) << 8 );      \
+    idx += stp;                                 \
+  } while (0)
+
+#define GETPCM(PCM,IDX) ( ( (PCM)[(IDX)>>FP]-128 ) << 8 )
+
+static zz_err_t init_meth(core_t * P);
+static i16_t push_nat(core_t * P, void * pcm, i16_t N);
+static i16_t skip_nat(core_t * P, i16_t N);
+
+#include "mix_common.c"
+
+static zz_err_t init_meth(core_t * P)
+{
+  nat_t * const nat = &((mix_fp_t *)P->data)->nat;
+
+  nat->spr = mulu(P->song.khz, 1000u);
+  if (nat->spr > P->spr)
+    nat->spr = P->spr;
+
+  /* Silence before the first pcm. */
+  nat->pos = nat->cnt = FIR_PREV;
+  nat->frac = nat->ofs = 0;
+  dmsg("voices at %luhz, output at %luhz\n", LU(nat->spr), LU(P->spr));
+  return E_OK;
+}
+
+/* Mix native pcm until there are at least need in the buffer. */
+static void
+nat_fill(core_t * const P, mix_fp_t * const M, u32_t need)
+{
+  nat_t * const nat = &M->nat;
+  int16_t tmp[2*BLKMAX];
+
+  if (need > NAT_MAX) {
+    /* GB: Keep what the kernel reads back from the current pcm. */
+    const u32_t drop = nat->pos - FIR_PREV;
+
+    zz_assert( nat->pos >= FIR_PREV );
+    zz_assert( need - drop <= NAT_MAX );
+    nat->cnt -= drop;
+    nat->pos -= drop;
+    need     -= drop;
+    memmove(nat->buf[0], nat->buf[0]+drop, nat->cnt*sizeof(int16_t));
+    memmove(nat->buf[1], nat->buf[1]+drop, nat->cnt*sizeof(int16_t));
+  }
+
+  while (nat->cnt < need) {
+    int16_t * const l = nat->buf[0] + nat->cnt;
+    int16_t * const r = nat->buf[1] + nat->cnt;
+    const int n = need - nat->cnt < BLKMAX ? need - nat->cnt : BLKMAX;
+    int k;
+
+    mix_voices(P, M, tmp, ZZ_PCM_I16, n);
+    for (k=0; k<n; ++k) {
+      l[k] = tmp[2*k+0];
+      r[k] = tmp[2*k+1];
+    }
+    nat->cnt += n;
+  }
+}
+
+/* Resample n (up to BLKMAX) pcm of one native channel. */
+static void
+nat_fir(int16_t * d, const int16_t * pcm, u32_t idx, const u32_t stp,
+        const u32_t lim, const int n)
+{
+  int k = simd_fir(d, pcm, idx, stp, n, lim);
+
+  for (idx += k*stp; k<n; ++k, idx += stp)
+    d[k] = fir_pcm(pcm, idx);
+}
+
+/* Convert N pcm to pcm (0: only mix the native pcm). */
+static void
+nat_run(core_t * const P, mix_fp_t * const M, void * restrict pcm, i16_t N)
+{
+  nat_t * const nat = &M->nat;
+  int16_t l[BLKMAX], r[BLKMAX];
+  u32_t stp;
+  i16_t rem = N;
+
+  stp = ( (u64_t) nat->spr << FP ) / P->spr;
+  while (rem > 0) {
+    const int n = rem < BLKMAX - nat->ofs ? rem : BLKMAX - nat->ofs;
+    const u32_t rel =
+      ( ( (u64_t) nat->frac << FP ) / P->spr ) + nat->ofs * stp;
+
+    /* Native pcm needed by the last output pcm of this block. */
+    nat_fill(P, M, nat->pos + FIR_HALF + 2 +
+             ( ( rel + ( n - 1u ) * stp ) >> FP ));
+
+    if (pcm) {
+      const u32_t idx = ( nat->pos << FP ) + rel;
+      STATS_START(P,u);
+      nat_fir(l, nat->buf[0], idx, stp, nat->cnt, n);
+      nat_fir(r, nat->buf[1], idx, stp, nat->cnt, n);
+      pcm = map_i16_to_pcm(pcm, P->pcmfmt, l, l, r, r, 256, 0, n);
+      STATS_STAGE(P,map,u,n);
+    }
+
+    /* GB: Exact position on every BLKMAX output pcm. */
+    nat->ofs += n;
+    if (nat->ofs == BLKMAX) {
+      nat->frac += BLKMAX * nat->spr;
+      nat->pos  += nat->frac / P->spr;
+      nat->frac %= P->spr;
+      nat->ofs   = 0;
+    }
+    rem -= n;
+  }
+}
+
+static i16_t
+push_nat(core_t * const P, void * restrict pcm, i16_t N)
+{
+  mix_fp_t * const M = (mix_fp_t *)P->data;
+  STATS_START(P,t);
+
+  zz_assert( P );
+  zz_assert( M );
+  zz_assert( pcm );
+  zz_assert( N > 0 );
+
+  if (mix_trig(P, M))
+    return -1;
+  STATS_STAGE(P,trig,t,1);
+
+  if (M->nat.spr == P->spr)
+    mix_voices(P, M, pcm, P->pcmfmt, N);
+  else
+    nat_run(P, M, pcm, N);
+  STATS_ADD(P,clips,mix_clips(pcm, P->pcmfmt, N));
+
+  return N;
+}
+
+/* GB: Skipping still mixes the native pcm the converter reads, only
+ *     the conversion is saved. */
+static i16_t
+skip_nat(core_t * const P, i16_t N)
+{
+  mix_fp_t * const M = (mix_fp_t *)P->data;
+  int k;
+
+  zz_assert( N > 0 );
+  if (mix_trig(P, M))
+    return -1;
+  if (M->nat.spr != P->spr)
+    nat_run(P, M, 0, N);
+  else
+    for (k=0; k<4; ++k)
+      mix_skip(M->chan+k, N);
+  return N;
+}
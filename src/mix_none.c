@@ -24,4 +24,6 @@ static zz_err_t init_meth(core_t *P)
   return ZZ_OK;
 }
 
+#define GETPCM(PCM,IDX) ( ( (PCM)[(IDX)>>FP]-128 ) << 8 )
+
 #include "mix_common.c"
@@ -67,20 +67,20 @@ static inline i16_t lagrange(const uint8_t * const pcm, u32_t idx)
   return r;
 }
 
-static zz_err_t init_meth(core_t * P)
+static zz_err_t prep_qerp(vset_t * vset)
 {
-  const uint8_t * end = (uint8_t *)P->vset.bin->ptr+P->vset.bin->max;
+  const uint8_t * end = vset->bin->ptr+vset->bin->max;
   int i;
 
-  for (i=0; i<P->vset.nbi; ++i) {
-    const i32_t len = P->vset.inst[i].len;
-    const i32_t lpl = P->vset.inst[i].lpl;
+  for (i=0; i<vset->nbi; ++i) {
+    const i32_t len = vset->inst[i].len;
+    const i32_t lpl = vset->inst[i].lpl;
 
     if (len) {
-      uint8_t * const pcm = P->vset.inst[i].pcm;
+      uint8_t * const pcm = vset->inst[i].pcm;
 
-      P->vset.inst[i].end = len+2;  /* qerp needs 2 additional PCMs */
-      if (pcm+P->vset.inst[i].end > end) {
+      vset->inst[i].end = len+2;  /* qerp needs 2 additional PCMs */
+      if (pcm+vset->inst[i].end > end) {
         emsg(METH ": I#%02hu out of range\n",HU(i));
         return E_MIX;
       }
@@ -97,4 +97,13 @@ static zz_err_t init_meth(core_t * P)
   return E_OK;
 }
 
+static zz_err_t init_meth(core_t * P)
+{
+  return vset_prepare(&P->vset, prep_qerp);
+}
+
+#define SIMDRUN simd_qerp		/* vector kernel */
+#define FUSERUN simd_fuse_qerp	/* fused vector kernel */
+#define GETPCM(PCM,IDX) lagrange(PCM,IDX)
+
 #include "mix_common.c"
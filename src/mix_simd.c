@@ -0,0 +1,763 @@
+/**
+ * @file   mix_simd.c
+ * @author Benjamin Gerard AKA Ben/OVR
+ * @date   2026-10-16
+ * @brief  Vector kernels for the mixers (runtime dispatch).
+ */
+
+#define ZZ_DBG_PREFIX "(vec) "
+#include "zz_private.h"
+
+/* GB: Each kernel processes the head of a run and returns the number
+ *     of pcm it did. The caller finishes the tail with its scalar
+ *     code which remains the reference. Kernels are bit-exact with
+ *     it.
+ *
+ *     Only x86_64 is supported for now. On i386 the float path of
+ *     the scalar code might use the x87 FPU and could not match.
+ */
+
+#if !defined NO_SIMD && defined __x86_64__ && defined __GNUC__ && FP <= 15
+# define SIMD_X86 1
+#endif
+
+typedef struct simd_s simd_t;
+
+struct simd_s {
+  const char * name;
+  int (*lerp)(int16_t *, const uint8_t *, u32_t, u32_t, int, u32_t);
+  int (*qerp)(int16_t *, const uint8_t *, u32_t, u32_t, int, u32_t);
+  int (*fir)(int16_t *, const int16_t *, u32_t, u32_t, int, u32_t);
+  int (*mapi)(int16_t *, const int16_t *, const int16_t *,
+              const int16_t *, const int16_t *, int, int, int);
+  int (*fuse_lerp)(int16_t *, mix_fuse_t *, int, int);
+  int (*fuse_qerp)(int16_t *, mix_fuse_t *, int, int);
+#ifndef NO_FLOAT
+  int (*mapf)(int16_t *, const float *, const float *,
+              const float *, const float *, float, float, int);
+#endif
+};
+
+/* ---------------------------------------------------------------------- */
+
+static int
+none_run(int16_t * d, const uint8_t * pcm, u32_t idx, u32_t stp,
+         int n, u32_t lim)
+{
+  return 0;
+}
+
+static int
+none_fir(int16_t * d, const int16_t * pcm, u32_t idx, u32_t stp,
+         int n, u32_t lim)
+{
+  return 0;
+}
+
+static int
+none_mapi(int16_t * d,
+          const int16_t * va, const int16_t * vb,
+          const int16_t * vc, const int16_t * vd,
+          int sc1, int sc2, int n)
+{
+  return 0;
+}
+
+/* GB: Without vector kernels the fused scalar loop of the caller is
+ *     the fastest path.
+ */
+static int
+none_fuse(int16_t * d, mix_fuse_t * v, int lr8, int n)
+{
+  return 0;
+}
+
+#ifndef NO_FLOAT
+static int
+none_mapf(int16_t * d,
+          const float * va, const float * vb,
+          const float * vc, const float * vd,
+          float sc1, float sc2, int n)
+{
+  return 0;
+}
+#endif
+
+static const simd_t simd_none = {
+  "scalar", none_run, none_run, none_fir, none_mapi, none_fuse, none_fuse,
+#ifndef NO_FLOAT
+  none_mapf
+#endif
+};
+
+#ifdef SIMD_X86
+
+#include <immintrin.h>
+
+/* Unaligned little-endian 32-bit read. */
+static inline int
+ld32(const uint8_t * p)
+{
+  uint32_t v;
+  zz_memcpy(&v, p, 4);
+  return v;
+}
+
+/* ----------------------------------------------------------------------
+ * SSE2 (8 pcm per step)
+ * ---------------------------------------------------------------------- */
+
+#define SSE2 __attribute__((target("sse2")))
+
+/* 4 gathered 32-bit reads */
+static inline __m128i SSE2 always_inline
+sse2_gather(const uint8_t * pcm, u32_t idx, u32_t stp)
+{
+  const int i0 = idx >> FP; idx += stp;
+  const int i1 = idx >> FP; idx += stp;
+  const int i2 = idx >> FP; idx += stp;
+  const int i3 = idx >> FP;
+  return _mm_set_epi32(ld32(pcm+i3), ld32(pcm+i2),
+                       ld32(pcm+i1), ld32(pcm+i0));
+}
+
+/* byte #s of each 32-bit lane as signed pcm, packed to 16-bit */
+static inline __m128i SSE2 always_inline
+sse2_byte(__m128i g0, __m128i g1, int s)
+{
+  const __m128i ff = _mm_set1_epi32(0xFF), x80 = _mm_set1_epi16(128);
+  g0 = _mm_and_si128(_mm_srli_epi32(g0, s<<3), ff);
+  g1 = _mm_and_si128(_mm_srli_epi32(g1, s<<3), ff);
+  return _mm_sub_epi16(_mm_packs_epi32(g0, g1), x80);
+}
+
+/* int:fir kernel pcm and phase (rounded to the nearest one) */
+#define FIR_POS(IDX) ( ((IDX) + (1 << (FP-FIR_PHASE-1))) >> (FP-FIR_PHASE) )
+#define FIR_PCM(P)   ( (P) >> FIR_PHASE )
+#define FIR_PHA(P)   ( (P) & (FIR_PHASES-1) )
+#define FIR_CLIP(R)  ( (R) < -0x8000 ? -0x8000 : (R) > 0x7FFF ? 0x7FFF : (R) )
+
+/* sign extended 16-bit to 32-bit */
+#define SSE2_LO32(V) _mm_srai_epi32(_mm_unpacklo_epi16((V),(V)), 16)
+#define SSE2_HI32(V) _mm_srai_epi32(_mm_unpackhi_epi16((V),(V)), 16)
+
+static int SSE2
+sse2_lerp(int16_t * d, const uint8_t * pcm, u32_t idx, u32_t stp,
+          int n, u32_t lim)
+{
+  const __m128i fpm = _mm_set1_epi32((1<<FP)-1);
+  const __m128i st4 = _mm_set1_epi32(stp*4);
+  __m128i ix0 = _mm_add_epi32(_mm_set1_epi32(idx),
+                              _mm_setr_epi32(0, stp, stp*2, stp*3));
+  __m128i ix1 = _mm_add_epi32(ix0, st4);
+  int k;
+
+  if (lim >> (32-FP))
+    return 0;                           /* 32-bit lanes */
+
+  for (k=0; k+8 <= n; k += 8, idx += stp*8) {
+    __m128i g0, g1, a, b, j, lo, hi, r0, r1;
+
+    if ( ((idx+stp*7) >> FP) + 3 >= lim )
+      break;
+
+    g0 = sse2_gather(pcm, idx, stp);
+    g1 = sse2_gather(pcm, idx+stp*4, stp);
+    a  = sse2_byte(g0, g1, 0);
+    b  = _mm_sub_epi16(sse2_byte(g0, g1, 1), a);
+    j  = _mm_packs_epi32(_mm_and_si128(ix0, fpm),
+                         _mm_and_si128(ix1, fpm));
+
+    /* a<<8 + (b-a)*j >> (FP-8) */
+    lo = _mm_mullo_epi16(b, j);
+    hi = _mm_mulhi_epi16(b, j);
+    r0 = _mm_add_epi32(_mm_slli_epi32(SSE2_LO32(a), 8),
+                       _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), FP-8));
+    r1 = _mm_add_epi32(_mm_slli_epi32(SSE2_HI32(a), 8),
+                       _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), FP-8));
+    _mm_storeu_si128((__m128i *)(d+k), _mm_packs_epi32(r0, r1));
+
+    ix0 = _mm_add_epi32(ix1, st4);
+    ix1 = _mm_add_epi32(ix0, st4);
+  }
+  return k;
+}
+
+static int SSE2
+sse2_qerp(int16_t * d, const uint8_t * pcm, u32_t idx, u32_t stp,
+          int n, u32_t lim)
+{
+  const __m128i x7f = _mm_set1_epi32(0x7F);
+  const __m128i st4 = _mm_set1_epi32(stp*4);
+  __m128i ix0 = _mm_add_epi32(_mm_set1_epi32(idx),
+                              _mm_setr_epi32(0, stp, stp*2, stp*3));
+  __m128i ix1 = _mm_add_epi32(ix0, st4);
+  int k;
+
+  if (lim >> (32-FP))
+    return 0;                           /* 32-bit lanes */
+
+  for (k=0; k+8 <= n; k += 8, idx += stp*8) {
+    __m128i g0, g1, p1, p2, p3, a, b, j, ab, jj, r0, r1;
+
+    if ( ((idx+stp*7) >> FP) + 3 >= lim )
+      break;
+
+    g0 = sse2_gather(pcm, idx, stp);
+    g1 = sse2_gather(pcm, idx+stp*4, stp);
+    p1 = sse2_byte(g0, g1, 0);
+    p2 = sse2_byte(g0, g1, 1);
+    p3 = sse2_byte(g0, g1, 2);
+    j  = _mm_packs_epi32(
+      _mm_and_si128(_mm_srli_epi32(ix0, FP-7), x7f),
+      _mm_and_si128(_mm_srli_epi32(ix1, FP-7), x7f));
+
+    /* b = -3*p1 +4*p2 -p3 ; a = 2*p1 -4*p2 +2*p3 */
+    b = _mm_add_epi16(p1, _mm_slli_epi16(p1, 1));
+    b = _mm_sub_epi16(_mm_slli_epi16(p2, 2), _mm_add_epi16(p3, b));
+    a = _mm_slli_epi16(_mm_add_epi16(_mm_sub_epi16(p1, _mm_slli_epi16(p2, 1)),
+                                     p3), 1);
+
+    /* a*j*j + b*(j<<8) + c<<16 */
+    jj = _mm_mullo_epi16(j, j);
+    j  = _mm_slli_epi16(j, 8);
+    ab = _mm_unpacklo_epi16(a, b);
+    r0 = _mm_add_epi32(_mm_madd_epi16(ab, _mm_unpacklo_epi16(jj, j)),
+                       _mm_slli_epi32(SSE2_LO32(p1), 16));
+    ab = _mm_unpackhi_epi16(a, b);
+    r1 = _mm_add_epi32(_mm_madd_epi16(ab, _mm_unpackhi_epi16(jj, j)),
+                       _mm_slli_epi32(SSE2_HI32(p1), 16));
+
+    /* r*3 >> 10 */
+    r0 = _mm_srai_epi32(_mm_add_epi32(r0, _mm_slli_epi32(r0, 1)), 2+24-16);
+    r1 = _mm_srai_epi32(_mm_add_epi32(r1, _mm_slli_epi32(r1, 1)), 2+24-16);
+    _mm_storeu_si128((__m128i *)(d+k), _mm_packs_epi32(r0, r1));
+
+    ix0 = _mm_add_epi32(ix1, st4);
+    ix1 = _mm_add_epi32(ix0, st4);
+  }
+  return k;
+}
+
+/* 4 stereo pcm from 32-bit a,c and b,d interleaved pairs */
+static inline __m128i SSE2 always_inline
+sse2_map4(__m128i ac, __m128i bd, __m128i s12, __m128i s21)
+{
+  const __m128i l = _mm_srai_epi32(
+    _mm_add_epi32(_mm_madd_epi16(ac, s12), _mm_madd_epi16(bd, s12)), 9);
+  const __m128i r = _mm_srai_epi32(
+    _mm_add_epi32(_mm_madd_epi16(ac, s21), _mm_madd_epi16(bd, s21)), 9);
+  return _mm_packs_epi32(_mm_unpacklo_epi32(l, r),
+                         _mm_unpackhi_epi32(l, r));
+}
+
+static int SSE2
+sse2_mapi(int16_t * d,
+          const int16_t * va, const int16_t * vb,
+          const int16_t * vc, const int16_t * vd,
+          int sc1, int sc2, int n)
+{
+  const __m128i s12 = _mm_set1_epi32( (sc2<<16) | sc1 );
+  const __m128i s21 = _mm_set1_epi32( (sc1<<16) | sc2 );
+  int k;
+
+  for (k=0; k+8 <= n; k += 8) {
+    const __m128i a = _mm_loadu_si128((const __m128i *)(va+k));
+    const __m128i b = _mm_loadu_si128((const __m128i *)(vb+k));
+    const __m128i c = _mm_loadu_si128((const __m128i *)(vc+k));
+    const __m128i e = _mm_loadu_si128((const __m128i *)(vd+k));
+
+    _mm_storeu_si128((__m128i *)(d+2*k+0),
+                     sse2_map4(_mm_unpacklo_epi16(a, c),
+                               _mm_unpacklo_epi16(b, e), s12, s21));
+    _mm_storeu_si128((__m128i *)(d+2*k+8),
+                     sse2_map4(_mm_unpackhi_epi16(a, c),
+                               _mm_unpackhi_epi16(b, e), s12, s21));
+  }
+  return k;
+}
+
+#ifndef NO_FLOAT
+
+/* GB: Clamp before the 32-bit conversion which fails out of range
+ *     (the scalar code converts to i32_t). NaN goes through and
+ *     ends up as -32768 as it does in the scalar code.
+ */
+#define SSE2_CLAMP(F) _mm_max_ps(lo, _mm_min_ps(hi, (F)))
+
+static int SSE2
+sse2_mapf(int16_t * d,
+          const float * va, const float * vb,
+          const float * vc, const float * vd,
+          float sc1, float sc2, int n)
+{
+  const __m128 s1 = _mm_set1_ps(sc1), s2 = _mm_set1_ps(sc2);
+  const __m128 lo = _mm_set1_ps(-32769.0f), hi = _mm_set1_ps(32768.0f);
+  int k;
+
+  for (k=0; k+4 <= n; k += 4) {
+    const __m128 ab = _mm_add_ps(_mm_loadu_ps(va+k), _mm_loadu_ps(vb+k));
+    const __m128 cd = _mm_add_ps(_mm_loadu_ps(vc+k), _mm_loadu_ps(vd+k));
+    const __m128i l = _mm_cvttps_epi32(SSE2_CLAMP(
+      _mm_add_ps(_mm_mul_ps(ab, s1), _mm_mul_ps(cd, s2))));
+    const __m128i r = _mm_cvttps_epi32(SSE2_CLAMP(
+      _mm_add_ps(_mm_mul_ps(ab, s2), _mm_mul_ps(cd, s1))));
+    _mm_storeu_si128((__m128i *)(d+2*k),
+                     _mm_packs_epi32(_mm_unpacklo_epi32(l, r),
+                                     _mm_unpackhi_epi32(l, r)));
+  }
+  return k;
+}
+
+#endif /* NO_FLOAT */
+
+/* GB: One dot product per pcm (the taps are the vector). */
+static int SSE2
+sse2_fir(int16_t * d, const int16_t * pcm, u32_t idx, u32_t stp,
+         int n, u32_t lim)
+{
+  int k;
+
+  for (k=0; k<n; ++k, idx += stp) {
+    const u32_t p = FIR_POS(idx);
+    const int16_t * const q = pcm + FIR_PCM(p) - (FIR_TAPS/2-1);
+    const __m128i * const x = (const __m128i *) q;
+    const __m128i * const h = (const __m128i *) fir_coef[FIR_PHA(p)];
+    __m128i a;
+    int r;
+
+    if ( FIR_PCM(p) + FIR_TAPS/2 >= lim )
+      break;
+    a = _mm_add_epi32(
+      _mm_add_epi32(_mm_madd_epi16(_mm_loadu_si128(x+0),_mm_loadu_si128(h+0)),
+                    _mm_madd_epi16(_mm_loadu_si128(x+1),_mm_loadu_si128(h+1))),
+      _mm_add_epi32(_mm_madd_epi16(_mm_loadu_si128(x+2),_mm_loadu_si128(h+2)),
+                    _mm_madd_epi16(_mm_loadu_si128(x+3),_mm_loadu_si128(h+3))));
+    a = _mm_add_epi32(a, _mm_shuffle_epi32(a, 0x4E));
+    a = _mm_add_epi32(a, _mm_shuffle_epi32(a, 0xB1));
+    r = ( _mm_cvtsi128_si32(a) + (1 << 13) ) >> 14;
+    d[k] = FIR_CLIP(r);
+  }
+  return k;
+}
+
+static const simd_t simd_sse2 = {
+  "sse2", sse2_lerp, sse2_qerp, sse2_fir, sse2_mapi, 0, 0,
+#ifndef NO_FLOAT
+  sse2_mapf
+#endif
+};
+
+/* ----------------------------------------------------------------------
+ * AVX2 (16 pcm per step)
+ * ---------------------------------------------------------------------- */
+
+#define AVX2 __attribute__((target("avx2")))
+
+/* GB: The 16-bit packs work on 128-bit lanes. This puts the 64-bit
+ *     quarters back in order.
+ */
+#define AVX2_PACK(R0,R1) \
+  _mm256_permute4x64_epi64(_mm256_packs_epi32((R0),(R1)), 0xD8)
+
+/* byte #s of each 32-bit lane as signed pcm */
+static inline __m256i AVX2 always_inline
+avx2_byte(__m256i g, int s)
+{
+  return _mm256_sub_epi32(
+    _mm256_and_si256(_mm256_srli_epi32(g, s<<3), _mm256_set1_epi32(0xFF)),
+    _mm256_set1_epi32(128));
+}
+
+static inline __m256i AVX2 always_inline
+avx2_lerp8(const uint8_t * pcm, __m256i ix)
+{
+  const __m256i g = _mm256_i32gather_epi32(
+    (const int *)pcm, _mm256_srli_epi32(ix, FP), 1);
+  const __m256i a = avx2_byte(g, 0);
+  const __m256i b = avx2_byte(g, 1);
+  const __m256i j = _mm256_and_si256(ix, _mm256_set1_epi32((1<<FP)-1));
+
+  return _mm256_add_epi32(
+    _mm256_slli_epi32(a, 8),
+    _mm256_srai_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(b, a), j), FP-8));
+}
+
+static int AVX2
+avx2_lerp(int16_t * d, const uint8_t * pcm, u32_t idx, u32_t stp,
+          int n, u32_t lim)
+{
+  const __m256i st8 = _mm256_set1_epi32(stp*8);
+  __m256i ix0 = _mm256_add_epi32(
+    _mm256_set1_epi32(idx),
+    _mm256_mullo_epi32(_mm256_set1_epi32(stp),
+                       _mm256_setr_epi32(0,1,2,3,4,5,6,7)));
+  __m256i ix1 = _mm256_add_epi32(ix0, st8);
+  int k;
+
+  if (lim >> (32-FP))
+    return 0;                           /* 32-bit lanes */
+
+  for (k=0; k+16 <= n; k += 16, idx += stp*16) {
+    if ( ((idx+stp*15) >> FP) + 3 >= lim )
+      break;
+    _mm256_storeu_si256((__m256i *)(d+k),
+                        AVX2_PACK(avx2_lerp8(pcm, ix0),
+                                  avx2_lerp8(pcm, ix1)));
+    ix0 = _mm256_add_epi32(ix1, st8);
+    ix1 = _mm256_add_epi32(ix0, st8);
+  }
+  return k;
+}
+
+static inline __m256i AVX2 always_inline
+avx2_qerp8(const uint8_t * pcm, __m256i ix)
+{
+  const __m256i g = _mm256_i32gather_epi32(
+    (const int *)pcm, _mm256_srli_epi32(ix, FP), 1);
+  const __m256i p1 = avx2_byte(g, 0);
+  const __m256i p2 = avx2_byte(g, 1);
+  const __m256i p3 = avx2_byte(g, 2);
+  const __m256i j  = _mm256_and_si256(_mm256_srli_epi32(ix, FP-7),
+                                      _mm256_set1_epi32(0x7F));
+  /* b = -3*p1 +4*p2 -p3 ; a = 2*p1 -4*p2 +2*p3 */
+  const __m256i b = _mm256_sub_epi32(
+    _mm256_slli_epi32(p2, 2),
+    _mm256_add_epi32(p3, _mm256_add_epi32(p1, _mm256_slli_epi32(p1, 1))));
+  const __m256i a = _mm256_slli_epi32(
+    _mm256_add_epi32(_mm256_sub_epi32(p1, _mm256_slli_epi32(p2, 1)), p3), 1);
+  __m256i r;
+
+  r = _mm256_add_epi32(
+    _mm256_add_epi32(_mm256_mullo_epi32(a, _mm256_mullo_epi32(j, j)),
+                     _mm256_slli_epi32(_mm256_mullo_epi32(b, j), 8)),
+    _mm256_slli_epi32(p1, 16));
+  return _mm256_srai_epi32(_mm256_add_epi32(r, _mm256_slli_epi32(r, 1)),
+                           2+24-16);
+}
+
+static int AVX2
+avx2_qerp(int16_t * d, const uint8_t * pcm, u32_t idx, u32_t stp,
+          int n, u32_t lim)
+{
+  const __m256i st8 = _mm256_set1_epi32(stp*8);
+  __m256i ix0 = _mm256_add_epi32(
+    _mm256_set1_epi32(idx),
+    _mm256_mullo_epi32(_mm256_set1_epi32(stp),
+                       _mm256_setr_epi32(0,1,2,3,4,5,6,7)));
+  __m256i ix1 = _mm256_add_epi32(ix0, st8);
+  int k;
+
+  if (lim >> (32-FP))
+    return 0;                           /* 32-bit lanes */
+
+  for (k=0; k+16 <= n; k += 16, idx += stp*16) {
+    if ( ((idx+stp*15) >> FP) + 3 >= lim )
+      break;
+    _mm256_storeu_si256((__m256i *)(d+k),
+                        AVX2_PACK(avx2_qerp8(pcm, ix0),
+                                  avx2_qerp8(pcm, ix1)));
+    ix0 = _mm256_add_epi32(ix1, st8);
+    ix1 = _mm256_add_epi32(ix0, st8);
+  }
+  return k;
+}
+
+/* GB: 8 pcm of each voice per step, mixed without going through
+ *     memory. The lr8 mode is a constant once inlined (0:any 1:lr8=0
+ *     2:lr8=128 3:lr8=256); the special ones only need shifts.
+ */
+static inline int AVX2 always_inline
+avx2_fuse(int16_t * d, mix_fuse_t * v, const int lr8, const int n,
+          const int qerp, const int mode)
+{
+  const __m256i s12 = _mm256_set1_epi32( (lr8<<16) | (256-lr8) );
+  const __m256i s21 = _mm256_set1_epi32( ((256-lr8)<<16) | lr8 );
+  const __m256i seq = _mm256_setr_epi32(0,1,2,3,4,5,6,7);
+  __m256i ix[4], st[4];
+  int i, k;
+
+  for (i=0; i<4; ++i) {
+    if (v[i].lim >> (32-FP))
+      return 0;                         /* 32-bit lanes */
+    st[i] = _mm256_set1_epi32(v[i].stp*8);
+    ix[i] = _mm256_add_epi32(
+      _mm256_set1_epi32(v[i].idx),
+      _mm256_mullo_epi32(_mm256_set1_epi32(v[i].stp), seq));
+  }
+
+#define AVX2_GET8(I) ( qerp                                     \
+                      ? avx2_qerp8(v[I].pcm, ix[I])             \
+                      : avx2_lerp8(v[I].pcm, ix[I]) )
+
+  for (k=0; k+8 <= n; k += 8) {
+    __m256i l, r;
+
+    for (i=0; i<4; ++i)
+      if ( ((v[i].idx+v[i].stp*(k+7)) >> FP) + 3 >= v[i].lim )
+        goto done;
+
+    if (!mode) {
+      /* a,c and b,d 16-bit pairs as for avx2_map8() */
+      const __m256i ac = _mm256_blend_epi16(
+        AVX2_GET8(0), _mm256_slli_epi32(AVX2_GET8(2), 16), 0xAA);
+      const __m256i bd = _mm256_blend_epi16(
+        AVX2_GET8(1), _mm256_slli_epi32(AVX2_GET8(3), 16), 0xAA);
+      l = _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(ac, s12),
+                                             _mm256_madd_epi16(bd, s12)), 9);
+      r = _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(ac, s21),
+                                             _mm256_madd_epi16(bd, s21)), 9);
+    } else {
+      const __m256i ab = _mm256_add_epi32(AVX2_GET8(0), AVX2_GET8(1));
+      const __m256i cd = _mm256_add_epi32(AVX2_GET8(2), AVX2_GET8(3));
+      if (mode == 2)
+        l = r = _mm256_srai_epi32(_mm256_add_epi32(ab, cd), 2);
+      else {
+        l = _mm256_srai_epi32(mode == 1 ? ab : cd, 1);
+        r = _mm256_srai_epi32(mode == 1 ? cd : ab, 1);
+      }
+    }
+    for (i=0; i<4; ++i)
+      ix[i] = _mm256_add_epi32(ix[i], st[i]);
+
+    /* lanes: l0 r0 .. l3 r3 | l4 r4 .. l7 r7 already in order */
+    _mm256_storeu_si256((__m256i *)(d+2*k),
+                        _mm256_packs_epi32(_mm256_unpacklo_epi32(l, r),
+                                           _mm256_unpackhi_epi32(l, r)));
+  }
+done:
+  for (i=0; i<4; ++i)
+    v[i].idx += v[i].stp * k;
+  return k;
+#undef AVX2_GET8
+}
+
+static int AVX2
+avx2_fuse_lerp(int16_t * d, mix_fuse_t * v, int lr8, int n)
+{
+  switch (lr8) {
+  case 0:   return avx2_fuse(d, v, lr8, n, 0, 1);
+  case 128: return avx2_fuse(d, v, lr8, n, 0, 2);
+  case 256: return avx2_fuse(d, v, lr8, n, 0, 3);
+  }
+  return avx2_fuse(d, v, lr8, n, 0, 0);
+}
+
+static int AVX2
+avx2_fuse_qerp(int16_t * d, mix_fuse_t * v, int lr8, int n)
+{
+  switch (lr8) {
+  case 0:   return avx2_fuse(d, v, lr8, n, 1, 1);
+  case 128: return avx2_fuse(d, v, lr8, n, 1, 2);
+  case 256: return avx2_fuse(d, v, lr8, n, 1, 3);
+  }
+  return avx2_fuse(d, v, lr8, n, 1, 0);
+}
+
+/* 8 stereo pcm from 32-bit a,c and b,d interleaved pairs */
+static inline __m256i AVX2 always_inline
+avx2_map8(__m256i ac, __m256i bd, __m256i s12, __m256i s21)
+{
+  const __m256i l = _mm256_srai_epi32(
+    _mm256_add_epi32(_mm256_madd_epi16(ac, s12),
+                     _mm256_madd_epi16(bd, s12)), 9);
+  const __m256i r = _mm256_srai_epi32(
+    _mm256_add_epi32(_mm256_madd_epi16(ac, s21),
+                     _mm256_madd_epi16(bd, s21)), 9);
+  return _mm256_packs_epi32(_mm256_unpacklo_epi32(l, r),
+                            _mm256_unpackhi_epi32(l, r));
+}
+
+static int AVX2
+avx2_mapi(int16_t * d,
+          const int16_t * va, const int16_t * vb,
+          const int16_t * vc, const int16_t * vd,
+          int sc1, int sc2, int n)
+{
+  const __m256i s12 = _mm256_set1_epi32( (sc2<<16) | sc1 );
+  const __m256i s21 = _mm256_set1_epi32( (sc1<<16) | sc2 );
+  int k;
+
+  for (k=0; k+16 <= n; k += 16) {
+    const __m256i a = _mm256_loadu_si256((const __m256i *)(va+k));
+    const __m256i b = _mm256_loadu_si256((const __m256i *)(vb+k));
+    const __m256i c = _mm256_loadu_si256((const __m256i *)(vc+k));
+    const __m256i e = _mm256_loadu_si256((const __m256i *)(vd+k));
+    /* lanes: 0-3|8-11 and 4-7|12-15 */
+    const __m256i lo = avx2_map8(_mm256_unpacklo_epi16(a, c),
+                                 _mm256_unpacklo_epi16(b, e), s12, s21);
+    const __m256i hi = avx2_map8(_mm256_unpackhi_epi16(a, c),
+                                 _mm256_unpackhi_epi16(b, e), s12, s21);
+    _mm256_storeu_si256((__m256i *)(d+2*k+ 0),
+                        _mm256_permute2x128_si256(lo, hi, 0x20));
+    _mm256_storeu_si256((__m256i *)(d+2*k+16),
+                        _mm256_permute2x128_si256(lo, hi, 0x31));
+  }
+  return k;
+}
+
+#ifndef NO_FLOAT
+
+#define AVX2_CLAMP(F) _mm256_max_ps(lo, _mm256_min_ps(hi, (F)))
+
+static int AVX2
+avx2_mapf(int16_t * d,
+          const float * va, const float * vb,
+          const float * vc, const float * vd,
+          float sc1, float sc2, int n)
+{
+  const __m256 s1 = _mm256_set1_ps(sc1), s2 = _mm256_set1_ps(sc2);
+  const __m256 lo = _mm256_set1_ps(-32769.0f), hi = _mm256_set1_ps(32768.0f);
+  int k;
+
+  for (k=0; k+8 <= n; k += 8) {
+    const __m256 ab = _mm256_add_ps(_mm256_loadu_ps(va+k),
+                                    _mm256_loadu_ps(vb+k));
+    const __m256 cd = _mm256_add_ps(_mm256_loadu_ps(vc+k),
+                                    _mm256_loadu_ps(vd+k));
+    const __m256i l = _mm256_cvttps_epi32(AVX2_CLAMP(
+      _mm256_add_ps(_mm256_mul_ps(ab, s1), _mm256_mul_ps(cd, s2))));
+    const __m256i r = _mm256_cvttps_epi32(AVX2_CLAMP(
+      _mm256_add_ps(_mm256_mul_ps(ab, s2), _mm256_mul_ps(cd, s1))));
+    /* lanes: 0-3|4-7 already in order */
+    _mm256_storeu_si256((__m256i *)(d+2*k),
+                        _mm256_packs_epi32(_mm256_unpacklo_epi32(l, r),
+                                           _mm256_unpackhi_epi32(l, r)));
+  }
+  return k;
+}
+
+#endif /* NO_FLOAT */
+
+static int AVX2
+avx2_fir(int16_t * d, const int16_t * pcm, u32_t idx, u32_t stp,
+         int n, u32_t lim)
+{
+  int k;
+
+  for (k=0; k<n; ++k, idx += stp) {
+    const u32_t p = FIR_POS(idx);
+    const int16_t * const q = pcm + FIR_PCM(p) - (FIR_TAPS/2-1);
+    const __m256i * const x = (const __m256i *) q;
+    const __m256i * const h = (const __m256i *) fir_coef[FIR_PHA(p)];
+    __m256i a;
+    __m128i b;
+    int r;
+
+    if ( FIR_PCM(p) + FIR_TAPS/2 >= lim )
+      break;
+    a = _mm256_add_epi32(
+      _mm256_madd_epi16(_mm256_loadu_si256(x+0), _mm256_loadu_si256(h+0)),
+      _mm256_madd_epi16(_mm256_loadu_si256(x+1), _mm256_loadu_si256(h+1)));
+    b = _mm_add_epi32(_mm256_castsi256_si128(a),
+                      _mm256_extracti128_si256(a, 1));
+    b = _mm_add_epi32(b, _mm_shuffle_epi32(b, 0x4E));
+    b = _mm_add_epi32(b, _mm_shuffle_epi32(b, 0xB1));
+    r = ( _mm_cvtsi128_si32(b) + (1 << 13) ) >> 14;
+    d[k] = FIR_CLIP(r);
+  }
+  return k;
+}
+
+static const simd_t simd_avx2 = {
+  "avx2", avx2_lerp, avx2_qerp, avx2_fir, avx2_mapi,
+  avx2_fuse_lerp, avx2_fuse_qerp,
+#ifndef NO_FLOAT
+  avx2_mapf
+#endif
+};
+
+static const simd_t *
+simd_probe(void)
+{
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    return &simd_avx2;
+  if (__builtin_cpu_supports("sse2"))
+    return &simd_sse2;
+  return &simd_none;
+}
+
+#else
+
+static const simd_t *
+simd_probe(void)
+{
+  return &simd_none;
+}
+
+#endif /* SIMD_X86 */
+
+/* ---------------------------------------------------------------------- */
+
+static const simd_t * simd_cur;
+
+static inline const simd_t * always_inline
+simd_get(void)
+{
+  const simd_t * S = zz_atomic_get(&simd_cur);
+  if (unlikely(!S)) {
+    /* GB: Probing twice is harmless. */
+    S = simd_probe();
+    dmsg("kernels: %s\n", S->name);
+    zz_atomic_set(&simd_cur, S);
+  }
+  return S;
+}
+
+int
+simd_lerp(int16_t * d, const uint8_t * pcm, u32_t idx, u32_t stp,
+          int n, u32_t lim)
+{
+  return simd_get()->lerp(d, pcm, idx, stp, n, lim);
+}
+
+int
+simd_qerp(int16_t * d, const uint8_t * pcm, u32_t idx, u32_t stp,
+          int n, u32_t lim)
+{
+  return simd_get()->qerp(d, pcm, idx, stp, n, lim);
+}
+
+int
+simd_fir(int16_t * d, const int16_t * pcm, u32_t idx, u32_t stp,
+         int n, u32_t lim)
+{
+  return simd_get()->fir(d, pcm, idx, stp, n, lim);
+}
+
+int
+simd_map_i16(int16_t * d,
+             const int16_t * va, const int16_t * vb,
+             const int16_t * vc, const int16_t * vd,
+             int sc1, int sc2, int n)
+{
+  return simd_get()->mapi(d, va, vb, vc, vd, sc1, sc2, n);
+}
+
+int
+simd_fuse_lerp(int16_t * d, mix_fuse_t * v, int lr8, int n)
+{
+  const simd_t * const S = simd_get();
+  return S->fuse_lerp ? S->fuse_lerp(d, v, lr8, n) : -1;
+}
+
+int
+simd_fuse_qerp(int16_t * d, mix_fuse_t * v, int lr8, int n)
+{
+  const simd_t * const S = simd_get();
+  return S->fuse_qerp ? S->fuse_qerp(d, v, lr8, n) : -1;
+}
+
+#ifndef NO_FLOAT
+
+int
+simd_map_flt(int16_t * d,
+             const float * va, const float * vb,
+             const float * vc, const float * vd,
+             float sc1, float sc2, int n)
+{
+  return simd_get()->mapf(d, va, vb, vc, vd, sc1, sc2, n);
+}
+
+#endif /* NO_FLOAT */
@@ -16,7 +16,7 @@
 #define F32MAX 48
 #define FLIMAX (F32MAX)
 #define FLOMAX (F32MAX)
-#define BLKMAX (F32MAX)
+#define VOXMAX (F32MAX*21)		/* voice buffer (pcm) */
 
 typedef struct mix_data_s mix_data_t;
 typedef struct mix_chan_s mix_chan_t;
@@ -34,8 +34,7 @@ struct mix_chan_s {
   uint8_t *pte;                         /* end address */
 
   float    iflt[FLIMAX];                /* src input  buffer */
-  float    oflt[FLOMAX];                /* src output buffer */
-  float    buf[BLKMAX];                 /* channel pcm buffer*/
+  float    buf[VOXMAX];                 /* channel pcm buffer*/
 };
 
 struct mix_data_s {
@@ -43,6 +42,9 @@ struct mix_data_s {
   soxr_io_spec_t      ispec;
   double   rate, irate, orate, rate_min, rate_max;
   mix_chan_t chan[4];
+#ifndef NO_THREAD
+  mix_pool_t *pool;                     /* voice workers (ZZ_OPT_PAR) */
+#endif
 };
 
 /* ----------------------------------------------------------------------
@@ -129,6 +131,54 @@ restart_chan(mix_chan_t * const K)
 }
 
 
+/* ----------------------------------------------------------------------
+
+   Voice resampling
+
+   ---------------------------------------------------------------------- */
+
+/* Resample n pcm of voice k into its buffer. */
+static int
+chan_render(void * user, int k, int n)
+{
+  mix_data_t * const M = user;
+  mix_chan_t * const K = M->chan+k;
+  float * restrict flt = K->buf;
+
+  zz_assert( n <= VOXMAX );
+
+  while (n > 0) {
+    int odone, want;
+
+    if ( ! K->run ) {
+      zz_memclr(flt, n * sizeof(*flt));
+      break;
+    }
+
+    /* GB: Keep requests small. The resampler slews the ratio over
+     *     the first request following a change.
+     */
+    if ( (want = n) > FLOMAX )
+      want = FLOMAX;
+
+    odone = soxr_output(K->soxr, flt, want);
+    if (odone < 0) {
+      emsg_soxr(K,soxr_error(K->soxr));
+      return -1;
+    }
+    zz_assert ( odone <= want );
+
+    if (odone < want) {
+      zz_assert ( !K->ptr );
+      if (!K->ptr)
+        K->run = 0;
+    }
+    n   -= odone;
+    flt += odone;
+  }
+  return 0;
+}
+
 /* ----------------------------------------------------------------------
 
    Mixer Push
@@ -145,6 +195,10 @@ push_soxr(core_t * const P, void * pcm, i16_t N)
   const float fscl = 32000.0 / 2.0 / 256.0;
   const float rscl = (float) P->lr8 * fscl;
   const float lscl = (float) (256-P->lr8) * fscl;
+#ifndef NO_STATS
+  void * const out = pcm;
+#endif
+  STATS_START(P,t);
 
   zz_assert( P );
   zz_assert( M );
@@ -152,6 +206,8 @@ push_soxr(core_t * const P, void * pcm, i16_t N)
   zz_assert( N != 0 );
   zz_assert( N > 0 );
 
+  STATS_ADD(P,notes,stats_notes(P));
+
   /* Setup channels */
   for (k=0; k<4; ++k) {
     chan_t     * const C = P->chan+k;
@@ -190,54 +246,33 @@ push_soxr(core_t * const P, void * pcm, i16_t N)
     }
   }
 
+  STATS_STAGE(P,trig,t,1);
+
   /* Mix channels */
   while (rem > 0) {
-    const int n = rem < BLKMAX ? rem : BLKMAX;
+    const int n = rem < VOXMAX ? rem : VOXMAX;
     rem -= n;
 
-    /* 4 voices */
-    for (k=0; k<4; ++k) {
-      mix_chan_t * const K = M->chan+k;
-      float * restrict flt = K->buf;
-      int need;
-
-      for ( need = n; need > 0; ) {
-        int odone, want;
-
-        if ( ! K->run ) {
-          zz_memclr(flt, need * sizeof(*flt));
-          break;
-        }
-
-        if ( (want = need) > FLOMAX )
-          want = FLOMAX;
-
-        odone = soxr_output(K->soxr, K->oflt, want);
-        if (odone < 0) {
-          emsg_soxr(K,soxr_error(K->soxr));
-          return -1;
-        }
-        zz_assert ( odone <= want );
-
-        if (odone < want) {
-          zz_assert ( !K->ptr );
-          if (!K->ptr)
-            K->run = 0;
-        }
-        need -= odone;
-
-        zz_memcpy(flt, K->oflt, sizeof(float)*odone);
-        flt += odone;
-      }
-    }
+#ifndef NO_THREAD
+    if (M->pool) {
+      if (mix_pool_run(M->pool, n))
+        return -1;
+    } else
+#endif
+    for (k=0; k<4; ++k)
+      if (chan_render(M, k, n))
+        return -1;
+    STATS_STAGE(P,voice,t,4*n);
 
-    map_flt_to_i16(pcm,
-                   M->chan[0].buf, M->chan[1].buf,
-                   M->chan[2].buf, M->chan[3].buf,
-                   lscl, rscl, n);
-    pcm = ((int32_t*)pcm) + n;
+    pcm = map_flt_to_pcm(pcm, P->pcmfmt,
+                         M->chan[0].buf, M->chan[1].buf,
+                         M->chan[2].buf, M->chan[3].buf,
+                         lscl, rscl, n);
+    STATS_STAGE(P,map,t,n);
   }
 
+  STATS_ADD(P,clips,mix_clips(out, P->pcmfmt, N));
+
   return N;
 }
 
@@ -249,6 +284,9 @@ static void free_soxr(core_t * const P)
   if (M) {
     int k;
     zz_assert( M == P->data );
+#ifndef NO_THREAD
+    mix_pool_del(&M->pool);
+#endif
     for (k=0; k<4; ++k) {
       mix_chan_t * const K = M->chan+k;
       if (K->soxr) {
@@ -328,10 +366,16 @@ static zz_err_t init_soxr(core_t * const P, u32_t spr)
     }
   }
 
+#ifndef NO_THREAD
+  if (!ecode && (P->opts & ZZ_OPT_PAR)) {
+    mix_data_t * const M = P->data;
+    if (mix_pool_new(&M->pool, chan_render, M))
+      wmsg("voices will be resampled sequentially\n");
+  }
+#endif
+
   if (ecode)
     free_soxr(P);
-  else
-    i8tofl(0,0,0);                    /* trick to pre-init LUT */
 
   return ecode;
 }
@@ -180,6 +180,11 @@ push_cb(core_t * const P, void * restrict pcm, i16_t N)
   return N;
 }
 
+static zz_err_t prep_test(vset_t * vset)
+{
+  return vset_unroll(vset,0);
+}
+
 static void * local_calloc(u32_t size, zz_err_t * err)
 {
   void * ptr = 0;
@@ -206,7 +211,7 @@ static zz_err_t init_cb(core_t * const P, u32_t spr)
     if (spr > SPR_MAX) spr = SPR_MAX;
     P->spr = spr;
 
-    vset_unroll(&P->vset,0);
+    ecode = vset_prepare(&P->vset, prep_test);
   }
 
   return ecode;
@@ -25,7 +25,7 @@ static zz_err_t close(zz_out_t *);
 static zz_u16_t write(zz_out_t *, void *, zz_u16_t);
 
 static aoout_t aoo = {
-  { "<ao>", 0, 0, close, write }
+  { "<ao>", 0, 0, 0, close, write }
 };
 
 static zz_err_t
@@ -43,16 +43,20 @@ close(zz_out_t * out)
 }
 
 zz_out_t *
-out_ao_open(zz_u32_t hz, const char * uri)
+out_ao_open(zz_u32_t hz, zz_u8_t fmt, const char * uri)
 {
   zz_assert(!aoo.dev);
   if (aoo.dev) {
     errno = EAGAIN;
     return 0;
   }
+  if (fmt == ZZ_PCM_F32) {
+    emsg("libao: float pcm is not supported\n");
+    return 0;
+  }
 
   ao_initialize();
-  aoo.fmt.bits        = 16;
+  aoo.fmt.bits        = ZZ_PCM_SIZE(fmt) << 2;
   aoo.fmt.rate        = hz;
   aoo.fmt.channels    = 2;
   aoo.fmt.byte_format = AO_FMT_NATIVE;
@@ -72,7 +76,8 @@ out_ao_open(zz_u32_t hz, const char * uri)
       dmsg("libao: failed to initialize audio driver #%d \"%s\"\n",
            aoo.id, aoo.info->short_name);
     } else {
-      aoo.out.hz = aoo.fmt.rate;
+      aoo.out.hz  = aoo.fmt.rate;
+      aoo.out.fmt = fmt;
       if (aoo.info->type == AO_TYPE_LIVE) {
         aoo.out.name = "<ao>";
         aoo.out.uri  = aoo.info->short_name;
@@ -2,7 +2,7 @@
  * @file   out_raw.c
  * @author Benjamin Gerard AKA Ben/OVR
  * @date   2017-07-04
- * @brief  Raw file output (files/null/stdout/stderr) .
+ * @brief  Raw file output (files/null/stdout/stderr) and .wav files.
  */
 
 #define ZZ_DBG_PREFIX "(raw) "
@@ -35,16 +35,17 @@ typedef struct out_raw_s out_raw_t;
 struct out_raw_s {
   zz_out_t out;
   FILE    *fp;
+  zz_u32_t len;				/**< data bytes written. */
+  int8_t   wav;				/**< has a RIFF header.  */
 };
 
 static zz_err_t xclose(zz_out_t *);
 static zz_u16_t xwrite(zz_out_t *, void *, zz_u16_t);
 
-static out_raw_t raw = {
-  { "raw", 0, 0, xclose, xwrite }
-};
+static const zz_out_t raw_out = { "raw", 0, 0, 0, xclose, xwrite };
+static char null_fp;
 
-static FILE * const null_ptr = (FILE *)&raw;
+#define null_ptr ((FILE *)&null_fp)
 
 int8_t can_use_std = 3;
 
@@ -106,74 +107,169 @@ static int uri_is_stderr(const char * uri)
     ;
 }
 
-zz_out_t * out_raw_open(zz_u32_t hz, const char * uri)
+static out_raw_t * raw_new(zz_u32_t hz, zz_u8_t fmt, const char * uri)
 {
-  zz_assert( ! raw.fp );
+  out_raw_t * raw = 0;
+
+  if (zz_calloc(&raw, sizeof(*raw))) {
+    emsg("(%d) %s -- %s\n", errno, strerror(errno), uri);
+    return 0;
+  }
+  raw->out = raw_out;
+  raw->out.uri = uri;
+  raw->out.hz  = hz;
+  raw->out.fmt = fmt;
+  return raw;
+}
+
+zz_out_t * out_raw_open(zz_u32_t hz, zz_u8_t fmt, const char * uri)
+{
+  out_raw_t * raw = raw_new(hz, fmt, uri);
+
+  if (!raw)
+    return 0;
 
-  raw.fp = 0;
   if (uri_is_null(uri)) {
-    raw.out.name = "<null>";
-    raw.fp = null_ptr;
+    raw->out.name = "<null>";
+    raw->fp = null_ptr;
   }
   else if (uri_is_stdout(uri)) {
-    raw.out.name = "<stdout>";
-    if (set_file_binary(stdout))
-      return 0;
-    raw.fp = stdout;
+    raw->out.name = "<stdout>";
+    if (!set_file_binary(stdout))
+      raw->fp = stdout;
   }
   else if (uri_is_stderr(uri)) {
-    raw.out.name = "<stderr>";
-    if (set_file_binary(stderr))
-      return 0;
-    raw.fp = stderr;
+    raw->out.name = "<stderr>";
+    if (!set_file_binary(stderr))
+      raw->fp = stderr;
   }
   else {
-    raw.out.name = "<file>";
-    raw.fp = fopen(uri, "wb");
-    if (!raw.fp) {
+    raw->out.name = "<file>";
+    raw->fp = fopen(uri, "wb");
+    if (!raw->fp)
       emsg("open: (%d) %s -- %s\n", errno, strerror(errno), uri);
-      return 0;
-    }
   }
-  raw.out.uri = uri;
-  raw.out.hz  = hz;
-  return &raw.out;
+
+  if (!raw->fp) {
+    zz_free(&raw);
+    return 0;
+  }
+  return &raw->out;
+}
+
+/* ----------------------------------------------------------------------
+ * RIFF .wav file (stereo 16-bit, 32-bit or float)
+ * ---------------------------------------------------------------------- */
+
+#define WAV_HEAD 44
+
+static void le32(uint8_t * d, zz_u32_t v)
+{
+  d[0] = v; d[1] = v >> 8; d[2] = v >> 16; d[3] = v >> 24;
+}
+
+static void le16(uint8_t * d, zz_u16_t v)
+{
+  d[0] = v; d[1] = v >> 8;
 }
 
+static int wav_header(out_raw_t * raw)
+{
+  uint8_t hd[WAV_HEAD];
+  const zz_u16_t align = ZZ_PCM_SIZE(raw->out.fmt);
+
+  memcpy(hd+ 0,"RIFF",4); le32(hd+ 4, WAV_HEAD-8+raw->len);
+  memcpy(hd+ 8,"WAVE",4);
+  memcpy(hd+12,"fmt ",4); le32(hd+16, 16);
+  le16(hd+20, raw->out.fmt == ZZ_PCM_F32
+       ? 3 : 1);			/* IEEE float or PCM */
+  le16(hd+22, 2);			/* channels */
+  le32(hd+24, raw->out.hz);		/* sampling rate */
+  le32(hd+28, raw->out.hz * align);	/* bytes per second */
+  le16(hd+32, align);			/* block align */
+  le16(hd+34, align << 2);		/* bits per sample */
+  memcpy(hd+36,"data",4); le32(hd+40, raw->len);
+
+  return -(fwrite(hd, 1, WAV_HEAD, raw->fp) != WAV_HEAD);
+}
+
+zz_out_t * out_wav_open(zz_u32_t hz, zz_u8_t fmt, const char * uri)
+{
+  out_raw_t * raw = raw_new(hz, fmt, uri);
+
+  if (!raw)
+    return 0;
+
+  raw->out.name = "<wav>";
+  raw->wav = 1;
+  raw->fp = fopen(uri, "wb");
+  if (!raw->fp || wav_header(raw)) {
+    emsg("open: (%d) %s -- %s\n", errno, strerror(errno), uri);
+    if (raw->fp)
+      fclose(raw->fp);
+    zz_free(&raw);
+    return 0;
+  }
+  return &raw->out;
+}
+
+/* ---------------------------------------------------------------------- */
+
 static zz_err_t xclose(zz_out_t * out)
 {
-  if (out == &raw.out) {
-    if (raw.fp == null_ptr)
-      raw.fp = 0;
-    if (raw.fp) {
-      FILE * fp = raw.fp;
-      raw.fp = 0;
-      if ( (fflush(fp) | fclose(fp)) < 0 ) {
-        emsg("close: (%d) %s -- %s\n", errno, strerror(errno), raw.out.uri);
-        return ZZ_ESYS;
-      }
+  out_raw_t * raw = (out_raw_t *) out;
+  zz_err_t ecode = ZZ_OK;
+
+  if (raw->fp == null_ptr)
+    raw->fp = 0;
+  if (raw->fp) {
+    FILE * fp = raw->fp;
+    /* Patch the RIFF header with the final sizes. */
+    if (raw->wav && (fseek(fp, 0, SEEK_SET) || wav_header(raw))) {
+      emsg("wav: (%d) %s -- %s\n", errno, strerror(errno), out->uri);
+      ecode = ZZ_ESYS;
+    }
+    if ( (fflush(fp) | fclose(fp)) < 0 ) {
+      emsg("close: (%d) %s -- %s\n", errno, strerror(errno), out->uri);
+      ecode = ZZ_ESYS;
     }
   }
-  return ZZ_OK;
+  zz_free(&raw);
+  return ecode;
 }
 
 static zz_u16_t xwrite(zz_out_t * out, void * ptr, zz_u16_t n)
 {
+  out_raw_t * const raw = (out_raw_t *) out;
   zz_u16_t w = 0;
 
   zz_assert(n >= 0);
   zz_assert(ptr);
-  zz_assert(out == &raw.out);
+  zz_assert(out->write == xwrite);
 
-  if (n && ptr && out == &raw.out) {
-    if (raw.fp == null_ptr)
+  if (n && ptr) {
+    if (raw->fp == null_ptr)
       w = n;
     else {
-      w = fwrite(ptr,1,n,raw.fp);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+      if (raw->wav) {
+        /* RIFF is little endian (the buffer is ours to mess with). */
+        const zz_u16_t w = ZZ_PCM_SIZE(raw->out.fmt) >> 1;
+        uint8_t * b = ptr;
+        zz_u16_t i, j;
+        for (i = 0; i+w <= n; i += w)
+          for (j = 0; j < w>>1; ++j) {
+            const uint8_t t = b[i+j]; b[i+j] = b[i+w-1-j]; b[i+w-1-j] = t;
+          }
+      }
+#endif
+      w = fwrite(ptr,1,n,raw->fp);
       if (w == (zz_u16_t)-1)
-        emsg("write: (%d) %s -- %s\n", errno, strerror(errno),raw.out.uri);
+        emsg("write: (%d) %s -- %s\n", errno, strerror(errno),out->uri);
       else if (w != n)
-        emsg("write truncated (%hu) -- %s\n", HU(n-w), raw.out.uri);
+        emsg("write truncated (%hu) -- %s\n", HU(n-w), out->uri);
+      else
+        raw->len += w;
     }
   }
   return w;
@@ -12,6 +12,19 @@
 # error vfs_file.c should not be compiled with NO_LIBC or NO_VFS defined
 #endif
 
+#if !defined NO_MMAP && ( defined __unix__ || defined __APPLE__ )
+# include <unistd.h>
+# if defined _POSIX_MAPPED_FILES && _POSIX_MAPPED_FILES > 0
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  define WITH_MMAP 1
+# endif
+#endif
+
+#ifndef MAP_MIN
+# define MAP_MIN 0x4000			/* smaller are read */
+#endif
+
 /* ---------------------------------------------------------------------- */
 
 static zz_err_t x_reg(zz_vfs_dri_t);
@@ -26,6 +39,13 @@ static zz_u32_t x_read(vfs_t, void *, zz_u32_t);
 static zz_u32_t x_tell(vfs_t);
 static zz_u32_t x_size(vfs_t);
 static zz_err_t x_seek(vfs_t,zz_u32_t,zz_u8_t);
+#ifdef WITH_MMAP
+static void * x_map(vfs_t,zz_u32_t,zz_u32_t);
+static void x_unmap(void *,zz_u32_t,zz_u32_t);
+#else
+# define x_map   0
+# define x_unmap 0
+#endif
 
 /* ---------------------------------------------------------------------- */
 
@@ -35,7 +55,8 @@ static struct zz_vfs_dri_s file_dri = {
   x_ismine,
   x_new, x_del, x_uri,
   x_open, x_close, x_read,
-  x_tell, x_size, x_seek
+  x_tell, x_size, x_seek,
+  x_map, x_unmap
 };
 
 zz_vfs_dri_t zz_file_vfs(void) { return &file_dri; }
@@ -162,3 +183,59 @@ x_seek(vfs_t const _vfs, zz_u32_t offset, zz_u8_t whence)
   zz_assert ( ret == 0 || ret == -1 );
   return E_SYS & ret;
 }
+
+#ifdef WITH_MMAP
+
+static size_t
+page_mask(void)
+{
+  return sysconf(_SC_PAGESIZE) - 1;
+}
+
+/* GB: The file pages are mapped over an anonymous mapping large
+ *     enough for the extra bytes (mapping past the end of file would
+ *     fault). Both are private so the caller can write anywhere.
+ */
+static void *
+x_map(vfs_t const _vfs, zz_u32_t n, zz_u32_t x)
+{
+  vfs_file_t const fs = (vfs_file_t) _vfs;
+  const size_t pgm = page_mask();
+  struct stat st;
+  long pos;
+  size_t off, size;
+  uint8_t * base;
+
+  if (n < MAP_MIN
+      || -1 == (pos = ftell(fs->fp))
+      || -1 == fstat(fileno(fs->fp), &st)
+      || (u64_t) pos + n > (u64_t) st.st_size)
+    return 0;
+
+  off  = pos & pgm;
+  size = ( off + n + x + pgm ) & ~pgm;
+  base = mmap(0, size, PROT_READ|PROT_WRITE,
+              MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+  if (base == MAP_FAILED)
+    return 0;
+  if (MAP_FAILED == mmap(base, off+n, PROT_READ|PROT_WRITE,
+                         MAP_PRIVATE|MAP_FIXED, fileno(fs->fp), pos-off)
+      || -1 == fseek(fs->fp, n, SEEK_CUR)) {
+    fs->X.err = errno;
+    munmap(base, size);
+    return 0;
+  }
+  dmsg("map %lu+%lu @%lu -- %s\n", LU(n), LU(x), LU(pos), fs->uri);
+  return base + off;
+}
+
+static void
+x_unmap(void * ptr, zz_u32_t n, zz_u32_t x)
+{
+  const size_t pgm = page_mask();
+  const size_t off = (uintptr_t) ptr & pgm;
+
+  munmap((uint8_t *) ptr - off, ( off + n + x + pgm ) & ~pgm);
+}
+
+#endif /* WITH_MMAP */
@@ -62,7 +62,17 @@ static const char bugreport[] = \
 #include <errno.h>
 #include <limits.h>
 #include <getopt.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#ifndef NO_STATS
+# include <time.h>
+#endif
 
+#ifndef NO_THREAD
+# include <pthread.h>
+# include <unistd.h>			/* sysconf() */
+# include <time.h>			/* nanosleep() */
+#endif
 
 #ifdef WIN32
 #ifdef __MINGW32__
@@ -89,6 +99,7 @@ zz_vfs_dri_t zz_ice_vfs(void);	       /* vfs_ice.c */
 static char me[] = "zingzong";
 
 enum {
+  OUT_IS_DEF = -1,
   /* First (0) is default */
 #ifndef NO_AO
   OUT_IS_LIVE, OUT_IS_WAVE,
@@ -99,8 +110,14 @@ enum {
 /* Options */
 
 static int opt_splrate = SPR_DEF, opt_tickrate, opt_blend = BLEND_DEF;
-static int opt_mixerid = ZZ_MIXER_DEF;
-static int8_t opt_ignore, opt_mute, opt_help, opt_outtype, opt_cmap;
+static int opt_mixerid = ZZ_MIXER_DEF, opt_jobs = -1;
+#ifndef NO_THREAD
+# define AHEAD_MAX 10000		/* render ahead max (ms) */
+static int opt_ahead;			/* render ahead (ms), 0:off */
+#endif
+static int8_t opt_ignore, opt_mute, opt_help, opt_cmap, opt_fast, opt_par;
+static int8_t opt_stats;
+static int8_t opt_outtype = OUT_IS_DEF, opt_pcm = ZZ_PCM_I16;
 static char * opt_length, * opt_output;
 
 /* ----------------------------------------------------------------------
@@ -108,6 +125,16 @@ static char * opt_length, * opt_output;
  * ----------------------------------------------------------------------
  */
 
+#ifndef NO_THREAD
+static pthread_mutex_t log_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t job_lock = PTHREAD_MUTEX_INITIALIZER;
+# define LOCK(M)   pthread_mutex_lock(&M)
+# define UNLOCK(M) pthread_mutex_unlock(&M)
+#else
+# define LOCK(M)   zz_void
+# define UNLOCK(M) zz_void
+#endif
+
 static int8_t newline = 1;		/* newline tracker */
 ZZ_EXTERN_C int8_t can_use_std;		   /* out_raw.c */
 
@@ -146,6 +173,7 @@ static void mylog(zz_u8_t log, void * user, const char * fmt, va_list list)
 {
   FILE * out = log_file(log);
 
+  LOCK(log_lock);
   errcnt += log == ZZ_LOG_ERR;
   if (out) {
     if (log <= ZZ_LOG_WRN) {
@@ -156,6 +184,7 @@ static void mylog(zz_u8_t log, void * user, const char * fmt, va_list list)
     set_newline(fmt);
     fflush(out);
   }
+  UNLOCK(log_lock);
 }
 
 /* ----------------------------------------------------------------------
@@ -175,6 +204,7 @@ static void print_usage(int level)
   printf (
     "Usage: zingzong [OPTIONS] <song.4v> [<inst.set>]" "\n"
     "       zingzong [OPTIONS] <music.4q>"  "\n"
+    "       zingzong [OPTIONS] -j N <song|dir> ..." "\n"
     "\n"
     "  A Microdeal quartet music file player\n"
     "\n"
@@ -203,12 +233,23 @@ static void print_usage(int level)
     " -b --blend=[X,]Y   Set channel mapping and blending (see below).\n"
     " -m --mute=CHANS    Mute selected channels (bit-field or string).\n"
     " -i --ignore=CHANS  Ignore selected channels (bit-field or string).\n"
+    " -f --fast          Mix quiet ticks in one go (faster, same output).\n"
+    " -s --stats         Print where the time went after playing.\n"
+#ifndef NO_THREAD
+    " -p --parallel      Resample each voice on its own thread (soxr and\n"
+    "                    sinc mixers only, same output).\n"
+    " -a --ahead=MS      Render up to MS milliseconds ahead of the output\n"
+    "                    on another thread (default is 0:off).\n"
+#endif
     " -o --output=URI    Set output file name (-w or -c).\n"
-    " -c --stdout        Output raw PCM to stdout or file (native 16-bit).\n"
+    " -c --stdout        Output raw PCM to stdout or file (native endian).\n"
+    " -e --encoding=ENC  Set PCM encoding: s16 (default), s32 or f32.\n"
     " -n --null          Output to the void.\n"
 #ifndef NO_AO
     " -w --wav           Generated a .wav file.\n"
 #endif
+    " -j --jobs=N        Batch convert songs and directories with N threads\n"
+    "                    (0: one per CPU).\n"
     );
 
   puts(
@@ -228,11 +269,20 @@ static void print_usage(int level)
     " `-c/--stdout'  output to the specified file instead of `stdout'.\n"
     " `-w/--wav'     unless set output is a file based on song filename.\n"
 
+    "\n"
+    " With `-j/--jobs' each song is rendered to a .wav file (or a .raw file\n"
+    " with `-c/--stdout') named after the song. Directories are searched\n"
+    " recursively for .4v .4q .qts and .qta songs. The `-o/--output' option\n"
+    " sets the output directory (default is the current directory) where\n"
+    " sub-directories are created as needed. With more jobs than songs the\n"
+    " spare threads render segments of the same song.\n"
+
 #ifdef NO_AO
     "\n"
     "IMPORTANT:\n"
     " This version of zingzong has been built without libao support.\n"
-    " Therefore it can not produce audio output nor RIFF .wav file.\n"
+    " Therefore it can not produce audio output. RIFF .wav files are only\n"
+    " available in batch mode.\n"
 #endif
 
     "\n"
@@ -324,8 +374,6 @@ static const char * timestr(zz_u32_t ms)
 
 #endif
 
-#ifndef NO_AO
-
 /* GB: could probably use some portability work. */
 static char * baseext(char * s)
 {
@@ -336,6 +384,8 @@ static char * baseext(char * s)
   return s+l;
 }
 
+#ifndef NO_AO
+
 /**
  * Create .wav filename from another filename
  */
@@ -642,6 +692,21 @@ static int uint_mute(char * const arg, char * name)
   return mute;
 }
 
+/**
+ * Parse -e,--encoding=ENC.
+ */
+static int8_t pcm_arg(const char * arg, const char * name)
+{
+  static const char * const enc[] = { "s16", "s32", "f32" };
+  int8_t i;
+
+  for (i=0; i<3; ++i)
+    if (!strcasecmp(arg, enc[i]))
+      return i;
+  emsg("invalid encoding -- %s=%s\n", name, arg);
+  return -1;
+}
+
 /**
  * Parse -b,--blend=[X,]Y.
  */
@@ -676,6 +741,595 @@ static zz_err_t too_many_arguments(void)
   return ZZ_EARG;
 }
 
+/* ----------------------------------------------------------------------
+ * Batch mode (-j/--jobs)
+ * ----------------------------------------------------------------------
+ */
+
+#define JOB_PCM 4096			/* pcm per zz_play() call */
+#define JOB_SEC 15			/* seconds per song segment */
+#define JOB_BUF (4u<<20)		/* segments buffer max (bytes) */
+#define JOB_WRITE 0x8000		/* bytes per out->write() call */
+
+typedef struct job_s job_t;
+
+struct job_s {
+  char * song;				/* song path */
+  char * path;				/* output path (0:null) */
+};
+
+static struct {
+  job_t  * job;				/* jobs list */
+  uint_t   cnt, max;			/* jobs count and allocated */
+  uint_t   next, done, fail;		/* next job, done and failed */
+  int8_t   type;			/* 0:null 'r':raw 'w':wav */
+  uint8_t  seg;				/* threads per song */
+  zz_err_t ecode;			/* first error */
+  zz_u32_t max_ms;			/* play time */
+} jobs;
+
+/* Song files (".4v" ".4q" ".qts" ".qta" as extension or prefix). */
+static int job_is_song(const char * leaf)
+{
+  static const char * const ext[] = { "4v", "4q", "qts", "qta" };
+  const char * dot = strrchr(leaf,'.');
+  int i;
+
+  if (dot)
+    for (i=0; i<4; ++i) {
+      const int l = strlen(ext[i]);
+      if (!strcasecmp(dot+1,ext[i])
+	  || (!strncasecmp(leaf,ext[i],l) && leaf[l] == '.'))
+	return 1;
+    }
+  return 0;
+}
+
+static char * job_strcat(const char * a, const char * b, const char * c)
+{
+  const int la = strlen(a), lb = strlen(b), lc = strlen(c);
+  char * s = 0;
+
+  if (zz_malloc(&s, la+lb+lc+1)) {
+    emsg("(%d) %s -- %s%s\n", errno, strerror(errno), a, b);
+    return 0;
+  }
+  memcpy(s,a,la); memcpy(s+la,b,lb); memcpy(s+la+lb,c,lc+1);
+  return s;
+}
+
+/**
+ * Add a song to the jobs list.
+ *
+ * @param  song  song path
+ * @param  rel   output path relative to the output directory
+ */
+static zz_err_t job_add(const char * song, const char * rel)
+{
+  job_t * job;
+
+  if (jobs.cnt == jobs.max) {
+    job_t * tmp = 0;
+    const uint_t max = jobs.max ? jobs.max << 1 : 64;
+    if (zz_malloc(&tmp, max * sizeof(*tmp))) {
+      emsg("(%d) %s -- %s\n", errno, strerror(errno), song);
+      return ZZ_ESYS;
+    }
+    if (jobs.job)
+      memcpy(tmp, jobs.job, jobs.cnt * sizeof(*tmp));
+    zz_free(&jobs.job);
+    jobs.job = tmp;
+    jobs.max = max;
+  }
+
+  job = jobs.job + jobs.cnt;
+  job->path = 0;
+  job->song = job_strcat(song,"","");
+  if (!job->song)
+    return ZZ_ESYS;
+
+  if (jobs.type) {
+    char * tmp = job_strcat(opt_output ? opt_output : ".", "/", rel);
+    if (tmp) {
+      *baseext(basename(tmp)) = 0;
+      job->path = job_strcat(tmp, jobs.type == 'w' ? ".wav" : ".raw", "");
+      zz_free(&tmp);
+    }
+    if (!job->path) {
+      zz_free(&job->song);
+      return ZZ_ESYS;
+    }
+  }
+  dmsg("job #%lu: \"%s\" -> \"%s\"\n",
+       LU(jobs.cnt), job->song, job->path ? job->path : "null:");
+  ++jobs.cnt;
+  return ZZ_OK;
+}
+
+/**
+ * Add all songs of a directory tree to the jobs list.
+ *
+ * @param  path  directory path
+ * @param  root  length of the top directory path prefix
+ */
+static zz_err_t job_scan(const char * path, int root)
+{
+  zz_err_t ecode = ZZ_OK;
+  struct dirent * ent;
+  DIR * dir = opendir(path);
+
+  if (!dir) {
+    emsg("opendir: (%d) %s -- %s\n", errno, strerror(errno), path);
+    return ZZ_EINP;
+  }
+
+  while (!ecode && (ent = readdir(dir)) != 0) {
+    struct stat st;
+    char * sub;
+
+    if (ent->d_name[0] == '.')
+      continue;				/* "." ".." and hidden files */
+    sub = job_strcat(path, "/", ent->d_name);
+    if (!sub)
+      ecode = ZZ_ESYS;
+    else if (stat(sub, &st))
+      wmsg("stat: (%d) %s -- %s\n", errno, strerror(errno), sub);
+    else if (S_ISDIR(st.st_mode))
+      ecode = job_scan(sub, root);
+    else if (job_is_song(ent->d_name))
+      ecode = job_add(sub, sub+root);
+    zz_free(&sub);
+  }
+  closedir(dir);
+  return ecode;
+}
+
+static int job_cmp(const void * a, const void * b)
+{
+  const job_t * ja = a, * jb = b;
+  return ja->path
+    ? strcmp(ja->path, jb->path)
+    : strcmp(ja->song, jb->song)
+    ;
+}
+
+/* Sort the jobs list and drop songs sharing the same output. */
+static void job_sort(void)
+{
+  uint_t i, j;
+
+  qsort(jobs.job, jobs.cnt, sizeof(*jobs.job), job_cmp);
+  for (i = j = 0; i < jobs.cnt; ++i) {
+    job_t * const job = jobs.job + i;
+    if (j && job->path && !strcmp(job->path, jobs.job[j-1].path)) {
+      wmsg("skipping \"%s\" (same output as \"%s\")\n",
+	   job->song, jobs.job[j-1].song);
+      zz_free(&job->song);
+      zz_free(&job->path);
+    } else
+      jobs.job[j++] = *job;
+  }
+  jobs.cnt = j;
+}
+
+/* Create the missing directories of a file path. */
+static void job_mkdir(char * path)
+{
+  char * s;
+
+  for (s = path+1; (s = strchr(s,'/')) != 0; ++s) {
+    *s = 0;
+#ifdef WIN32
+    mkdir(path);
+#else
+    mkdir(path, 0777);
+#endif
+    *s = '/';
+  }
+}
+
+static zz_out_t * job_open(job_t * job, zz_u32_t hz)
+{
+  if (!job->path)
+    return out_raw_open(hz, opt_pcm, "null:");
+  job_mkdir(job->path);
+  return jobs.type == 'w'
+    ? out_wav_open(hz, opt_pcm, job->path)
+    : out_raw_open(hz, opt_pcm, job->path)
+    ;
+}
+
+/* Render a song with a reusable player. */
+static zz_err_t job_render(zz_play_t P, job_t * job, int32_t * pcm)
+{
+  zz_err_t ecode;
+  zz_info_t info;
+  zz_out_t * out = 0;
+  zz_u8_t format;
+  uint_t done;
+
+  ecode = zz_load(P, job->song, 0, &format);
+  if (!ecode)
+    ecode = zz_init(P, opt_tickrate, jobs.max_ms);
+  if (!ecode) {
+    if (opt_fast)
+      zz_core_opts((void*)P, 0, ZZ_OPT_SPAN);
+    if (opt_par)
+      zz_core_opts((void*)P, 0, ZZ_OPT_PAR);
+    ecode = zz_setup(P, opt_mixerid, opt_splrate);
+  }
+  if (!ecode) {
+    zz_core_mute((void*)P, 0xFF, (opt_mute<<4)|opt_ignore);
+    zz_core_pcm((void*)P, opt_pcm);
+    ecode = zz_info(P, &info);
+  }
+  if (!ecode && !(out = job_open(job, info.mix.spr)))
+    ecode = ZZ_EOUT;
+
+  if (!ecode && jobs.seg > 1) {
+    /* GB: Fewer songs than jobs. Spare threads render segments of
+     *     the same song (see zz_render_parallel()). */
+    const zz_u32_t size = ZZ_PCM_SIZE(opt_pcm);
+    zz_u32_t max = (zz_u32_t) jobs.seg * JOB_SEC * info.mix.spr;
+    uint8_t * buf = 0;
+
+    if (max > JOB_BUF / size)
+      max = JOB_BUF / size;
+    ecode = zz_malloc(&buf, max * size);
+    while (!ecode) {
+      zz_u32_t n = max, i, w;
+      ecode = zz_render_parallel(P, buf, &n, jobs.seg);
+      if (ecode || !n)
+	break;
+      /* GB: write() counts are 16-bit on some targets. */
+      for (n *= size, i = 0; !ecode && i < n; i += w) {
+	w = n-i < JOB_WRITE ? n-i : JOB_WRITE;
+	if (w != out->write(out, buf+i, w))
+	  ecode = ZZ_EOUT;
+      }
+    }
+    zz_free(&buf);
+  }
+
+  while (!ecode) {
+    zz_i16_t n = zz_play(P, pcm, JOB_PCM*4 / ZZ_PCM_SIZE(opt_pcm));
+    if (n <= 0) {
+      ecode = -n;
+      break;
+    }
+    n *= ZZ_PCM_SIZE(opt_pcm);
+    if (n != out->write(out, pcm, n))
+      ecode = ZZ_EOUT;
+  }
+
+  if (out && out->close(out) && !ecode)
+    ecode = ZZ_EOUT;
+  if (out && ecode && job->path)
+    remove(job->path);
+  zz_close(P);
+
+  LOCK(job_lock);
+  done = ++jobs.done;
+  if (ecode) {
+    ++jobs.fail;
+    if (!jobs.ecode)
+      jobs.ecode = ecode;
+  }
+  UNLOCK(job_lock);
+
+  if (ecode)
+    emsg("(%hu) conversion failed -- %s\n", HU(ecode), job->song);
+  else
+    imsg("[%lu/%lu] \"%s\" -> \"%s\"\n", LU(done), LU(jobs.cnt),
+	 job->song, job->path ? job->path : "null:");
+
+  return ecode;
+}
+
+/* Worker: render songs until the list is exhausted. */
+static void * job_worker(void * user)
+{
+  zz_play_t P = user;
+  int32_t pcm[JOB_PCM];
+
+  if (!P && !zz_new(&P))
+    zz_arena(P, 0);			/* no allocator contention */
+
+  while (P) {
+    job_t * job = 0;
+    LOCK(job_lock);
+    if (jobs.next < jobs.cnt)
+      job = jobs.job + jobs.next++;
+    UNLOCK(job_lock);
+    if (!job)
+      break;
+    job_render(P, job, pcm);
+  }
+
+  if (P != user)
+    zz_del(&P);
+  return 0;
+}
+
+/**
+ * Batch convert songs and directories.
+ *
+ * @param  P     player instance (used by the calling thread)
+ * @param  argc  number of paths
+ * @param  argv  songs and directories paths
+ */
+static zz_err_t jobs_main(zz_play_t P, int argc, char ** argv)
+{
+  zz_err_t ecode = ZZ_OK;
+  uint_t i;
+  int n = opt_jobs;
+
+  switch (opt_outtype) {
+  case OUT_IS_NULL:   jobs.type = 0;   break;
+  case OUT_IS_STDOUT: jobs.type = 'r'; break;
+  default:            jobs.type = 'w'; break;
+  }
+
+  for (i = 0; !ecode && i < argc; ++i) {
+    struct stat st;
+    char * path = argv[i];
+    int l = strlen(path);
+
+    while (l > 1 && path[l-1] == '/')
+      path[--l] = 0;
+    if (stat(path, &st)) {
+      emsg("stat: (%d) %s -- %s\n", errno, strerror(errno), path);
+      ecode = ZZ_EINP;
+    } else if (S_ISDIR(st.st_mode))
+      ecode = job_scan(path, l+1);
+    else
+      ecode = job_add(path, basename(path));
+  }
+  if (ecode)
+    goto exit;
+  if (!jobs.cnt) {
+    emsg("no song to convert\n");
+    ecode = ZZ_EINP;
+    goto exit;
+  }
+  job_sort();
+
+#ifndef NO_THREAD
+# ifdef _SC_NPROCESSORS_ONLN
+  if (!n)
+    n = sysconf(_SC_NPROCESSORS_ONLN);
+# endif
+#endif
+  if (n < 1)
+    n = 1;
+  if (n > jobs.cnt) {
+    jobs.seg = n / jobs.cnt < ZZ_RENDER_MAX ? n / jobs.cnt : ZZ_RENDER_MAX;
+    n = jobs.cnt;
+  }
+  zz_core_blend(0, opt_cmap, opt_blend);
+  imsg("Converting %lu songs with %d job%s\n",
+       LU(jobs.cnt), n, n>1 ? "s" : "");
+
+#ifndef NO_THREAD
+  if (n > 1) {
+    pthread_t tid[n-1];
+    int k = 0;
+
+    for (; k < n-1; ++k) {
+      int err = pthread_create(tid+k, 0, job_worker, 0);
+      if (err) {
+	wmsg("thread: (%d) %s\n", err, strerror(err));
+	break;
+      }
+    }
+    job_worker(P);
+    while (k--)
+      pthread_join(tid[k], 0);
+  } else
+#endif
+    job_worker(P);
+
+  if (jobs.fail)
+    wmsg("%lu out of %lu songs failed\n", LU(jobs.fail), LU(jobs.cnt));
+  ecode = jobs.ecode;
+
+exit:
+  for (i = 0; i < jobs.cnt; ++i) {
+    zz_free(&jobs.job[i].song);
+    zz_free(&jobs.job[i].path);
+  }
+  zz_free(&jobs.job);
+  return ecode;
+}
+
+/* ----------------------------------------------------------------------
+ * Output stage (-s/--stats)
+ * ----------------------------------------------------------------------
+ */
+
+/* GB: The library only times its own stages, the output writes are
+ *     timed here.
+ */
+static struct zz_stage_s out_stage;
+
+static zz_u16_t out_write(zz_out_t * out, void * pcm, zz_u16_t n)
+{
+#ifndef NO_STATS
+  if (opt_stats) {
+    struct timespec t0, t1;
+    zz_u16_t r;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    r = out->write(out, pcm, n);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    out_stage.ns += (t1.tv_sec - t0.tv_sec) * 1000000000ll
+      + t1.tv_nsec - t0.tv_nsec;
+    out_stage.cnt += n / ZZ_PCM_SIZE(opt_pcm);
+    return r;
+  }
+#endif
+  return out->write(out, pcm, n);
+}
+
+/* ----------------------------------------------------------------------
+ * Render ahead (-a/--ahead)
+ * ----------------------------------------------------------------------
+ */
+
+#ifndef NO_THREAD
+
+#define RING_PCM   4096			/* max pcm per zz_play() call */
+#define RING_WRITE 0x8000		/* max bytes per out->write() */
+
+# define RING_GET(P)   __atomic_load_n((P), __ATOMIC_ACQUIRE)
+# define RING_SET(P,V) __atomic_store_n((P), (V), __ATOMIC_RELEASE)
+
+/* GB: Single producer (render thread) single consumer (output) ring
+ *     buffer. Each side only writes its own index so neither of them
+ *     ever waits for a lock. A side with nothing to do naps, a bit
+ *     longer each time up to a millisecond. Short naps matter when
+ *     the output is much faster than real time (files).
+ */
+typedef struct {
+  uint8_t * buf;			/* ring buffer (power of 2) */
+  uint32_t  msk;			/* buffer size - 1 */
+  uint32_t  head;			/* bytes produced */
+  uint32_t  tail;			/* bytes consumed */
+  uint32_t  high;			/* high-water mark */
+  uint32_t  under;			/* underruns */
+  int8_t    done;			/* producer is done */
+  int8_t    stop;			/* consumer wants to stop */
+  zz_err_t  ecode;			/* producer error */
+  zz_play_t play;			/* player */
+} ring_t;
+
+#define RING_NAP_MIN 8			/* shortest nap (us) */
+#define RING_NAP_MAX 1000		/* longest nap (us) */
+
+static void ring_nap(uint_t * nap)
+{
+  const struct timespec ts = { 0, *nap * 1000 };
+  nanosleep(&ts, 0);
+  if (*nap < RING_NAP_MAX)
+    *nap = *nap * 2 < RING_NAP_MAX ? *nap * 2 : RING_NAP_MAX;
+}
+
+/* Producer: render until done or stopped. */
+static void * ring_render(void * user)
+{
+  ring_t * const R = user;
+  const uint32_t size = ZZ_PCM_SIZE(opt_pcm);
+  uint32_t head = R->head;
+  uint_t nap = RING_NAP_MIN;
+
+  while (!RING_GET(&R->stop)) {
+    const uint32_t room = R->msk + 1 - (head - RING_GET(&R->tail));
+    const uint32_t wrap = R->msk + 1 - (head & R->msk);
+    uint32_t max = ( room < wrap ? room : wrap ) / size;
+    zz_i16_t n;
+
+    if (!max) {
+      ring_nap(&nap);
+      continue;
+    }
+    nap = RING_NAP_MIN;
+    if (max > RING_PCM)
+      max = RING_PCM;
+    n = zz_play(R->play, R->buf + (head & R->msk), max);
+    if (n <= 0) {
+      R->ecode = -n;
+      break;
+    }
+    head += n * size;
+    RING_SET(&R->head, head);
+  }
+  RING_SET(&R->done, 1);
+  return 0;
+}
+
+/* Consumer: write the rendered pcm as it comes. Underruns only mean
+ * something when the output is live (it can't wait for the renderer).
+ */
+static zz_err_t ring_play(zz_play_t P, zz_out_t * out, uint_t ms,
+			  int8_t live)
+{
+  const uint32_t size = ZZ_PCM_SIZE(opt_pcm);
+  const uint32_t want = (uint64_t) out->hz * ms / 1000u * size;
+  uint64_t bytes = 0;
+  ring_t R;
+  pthread_t tid;
+  zz_err_t ecode = ZZ_OK;
+  uint_t sec = (uint_t) -1, nap = RING_NAP_MIN;
+  int8_t empty = 1;
+  int err;
+
+  memset(&R, 0, sizeof(R));
+  R.play = P;
+  for (R.msk = RING_PCM * size; R.msk < want; R.msk <<= 1)
+    ;
+  if (zz_malloc(&R.buf, R.msk--))
+    return ZZ_ESYS;
+  dmsg("render ahead: %lu bytes\n", LU(R.msk+1));
+
+  err = pthread_create(&tid, 0, ring_render, &R);
+  if (err) {
+    emsg("thread: (%d) %s\n", err, strerror(err));
+    zz_free(&R.buf);
+    return ZZ_ESYS;
+  }
+
+  for (;;) {
+    const int8_t done = RING_GET(&R.done);
+    const uint32_t fill = RING_GET(&R.head) - R.tail;
+    const uint32_t wrap = R.msk + 1 - (R.tail & R.msk);
+    uint32_t n = fill < wrap ? fill : wrap;
+    zz_u32_t pos;
+
+    if (!n) {
+      if (done)
+	break;
+      /* Count once each time the output catches up (not on start) */
+      R.under += live && !empty && !!bytes;
+      empty = 1;
+      ring_nap(&nap);
+      continue;
+    }
+    empty = 0;
+    nap = RING_NAP_MIN;
+    if (fill > R.high)
+      R.high = fill;
+    if (n > RING_WRITE)
+      n = RING_WRITE;
+    if (n != out_write(out, R.buf + (R.tail & R.msk), n)) {
+      ecode = ZZ_EOUT;
+      break;
+    }
+    RING_SET(&R.tail, R.tail + n);
+    bytes += n;
+
+    pos = bytes / size / out->hz;
+    if (pos != sec) {
+      sec = pos;
+      imsg("\n |> %02u:%02u\r"+newline,
+	   sec / 60u, sec % 60u );
+      newline = 1;
+    }
+  }
+
+  RING_SET(&R.stop, 1);
+  pthread_join(tid, 0);
+  zz_free(&R.buf);
+
+  imsg("\nrender ahead: %lu ms, high-water %lu%%",
+       LU(ms), LU((uint64_t) R.high * 100u / (R.msk+1)));
+  if (live)
+    imsg(", %lu underrun%s", LU(R.under), R.under == 1 ? "" : "s");
+  imsg("\n");
+  return ecode ? ecode : R.ecode;
+}
+
+#endif /* NO_THREAD */
+
 /* ----------------------------------------------------------------------
  * Main
  * ----------------------------------------------------------------------
@@ -689,9 +1343,51 @@ static zz_err_t too_many_arguments(void)
 # define WAVOPT
 #endif
 
+#ifndef NO_THREAD
+# define PAROPT "pa:" /* voices resampled by worker threads, render ahead */
+#else
+# define PAROPT
+#endif
+
+/* ----------------------------------------------------------------------
+ * Statistics (-s/--stats)
+ * ----------------------------------------------------------------------
+ */
+
+static void
+print_stats(zz_play_t P)
+{
+  static const char * const names[] = {
+    "sequencer", "triggers", "resampling", "mapping", "zz_play()",
+    "output"
+  };
+  zz_stats_t st;
+  const struct zz_stage_s * stages[6];
+  int i;
+
+  if (zz_stats(P, &st)) {
+    wmsg("statistics are not available\n");
+    return;
+  }
+  stages[0] = &st.tick;  stages[1] = &st.trig; stages[2] = &st.voice;
+  stages[3] = &st.map;   stages[4] = &st.play;
+  stages[5] = &out_stage;
+
+  log_newline(ZZ_LOG_INF);
+  imsg("%-10s %10s %12s %10s\n", "stage", "ms", "count", "ns/count");
+  for (i=0; i<6; ++i)
+    imsg("%-10s %10.1f %12.0f %10.1f\n", names[i],
+	 stages[i]->ns / 1E6, (double) stages[i]->cnt,
+	 stages[i]->cnt ? (double) stages[i]->ns / stages[i]->cnt : 0.0);
+  imsg("notes: %.0f clips: %.0f peak: %lu pcm/tick\n",
+       (double) st.notes, (double) st.clips, LU(st.pcm_max));
+  for (i=0; i<ZZ_STATS_MIX && st.mix[i].name; ++i)
+    imsg("%-21s %12.0f\n", st.mix[i].name, (double) st.mix[i].cnt);
+}
+
 int main(int argc, char *argv[])
 {
-  static char sopts[] = "hV" WAVOPT "cno:" "r:t:l:m:i:b:";
+  static char sopts[] = "hV" WAVOPT "cnfso:" PAROPT "r:t:l:m:i:b:j:e:";
   static struct option lopts[] = {
     { "help",	 0, 0, 'h' },
     { "usage",	 0, 0, 'h' },
@@ -703,12 +1399,20 @@ int main(int argc, char *argv[])
     { "output",	 1, 0, 'o' },
     { "stdout",	 0, 0, 'c' },
     { "null",	 0, 0, 'n' },
+    { "fast",	 0, 0, 'f' },
+    { "stats",	 0, 0, 's' },
+#ifndef NO_THREAD
+    { "parallel",0, 0, 'p' },
+    { "ahead=",	 1, 0, 'a' },
+#endif
     { "tick=",	 1, 0, 't' },
     { "rate=",	 1, 0, 'r' },
     { "length=", 1, 0, 'l' },
     { "mute=",	 1, 0, 'm' },
     { "ignore=", 1, 0, 'i' },
     { "blend=",	 1, 0, 'b' },
+    { "jobs=",	 1, 0, 'j' },
+    { "encoding=",1, 0, 'e' },
     { 0 }
   };
   int c, ecode=ZZ_ERR, ecode2;
@@ -736,6 +1440,15 @@ int main(int argc, char *argv[])
     case 'o': opt_output = optarg; break;
     case 'n': opt_outtype = OUT_IS_NULL; break;
     case 'c': opt_outtype = OUT_IS_STDOUT; break;
+    case 'f': opt_fast = 1; break;
+    case 's': opt_stats = 1; break;
+#ifndef NO_THREAD
+    case 'p': opt_par = 1; break;
+    case 'a':
+      if (-1 == (opt_ahead = uint_arg(optarg,"ahead",0,AHEAD_MAX,0)))
+	RETURN (ZZ_EARG);
+      break;
+#endif
     case 'l': opt_length = optarg; break;
     case 'r':
       if (-1 == uint_spr(optarg, "rate", &opt_splrate, &opt_mixerid))
@@ -757,6 +1470,14 @@ int main(int argc, char *argv[])
       if (-1 == (opt_blend = uint_blend(optarg,"blend", &opt_cmap)))
 	RETURN (ZZ_EARG);
       break;
+    case 'j':
+      if (-1 == (opt_jobs = uint_arg(optarg,"jobs",0,256,0)))
+	RETURN (ZZ_EARG);
+      break;
+    case 'e':
+      if (-1 == (opt_pcm = pcm_arg(optarg,"encoding")))
+	RETURN (ZZ_EARG);
+      break;
     case 0: break;
     case '?':
       if (!opterr) {
@@ -794,9 +1515,11 @@ int main(int argc, char *argv[])
   if (optind >= argc)
     RETURN (too_few_arguments());
 
-  songuri = argv[optind++];
-  if (optind < argc)
-    vseturi = argv[optind++];
+  if (opt_jobs < 0) {
+    songuri = argv[optind++];
+    if (optind < argc)
+      vseturi = argv[optind++];
+  }
 
   if (1) {
     const char * name = "?", * desc;
@@ -820,6 +1543,12 @@ int main(int argc, char *argv[])
     goto error_exit;
   zz_assert( P );
 
+  if (opt_jobs >= 0) {
+    jobs.max_ms = max_ms;
+    ecode = jobs_main(P, argc-optind, argv+optind);
+    goto error_exit;
+  }
+
   ecode = zz_load(P, songuri, vseturi, &format);
   if (ecode)
     goto error_exit;
@@ -831,6 +1560,9 @@ int main(int argc, char *argv[])
    *  Output
    * ---------------------------------------- */
 
+  if (opt_outtype == OUT_IS_DEF)
+    opt_outtype = 0;
+
   switch (opt_outtype) {
 
 #ifndef NO_AO
@@ -842,19 +1574,20 @@ int main(int argc, char *argv[])
     if (ecode)
       goto error_exit;
   case OUT_IS_LIVE:
-    out = out_ao_open(opt_splrate, wavuri);
+    out = out_ao_open(opt_splrate, opt_pcm, wavuri);
     break;
 #endif
 
   case OUT_IS_STDOUT:
-    out = out_raw_open(opt_splrate, opt_output ? opt_output : "stdout:");
+    out = out_raw_open(opt_splrate, opt_pcm,
+		       opt_output ? opt_output : "stdout:");
     break;
 
   default:
     zz_assert(!"unexpected output type");
 
   case OUT_IS_NULL:
-    out = out_raw_open(opt_splrate,"null:");
+    out = out_raw_open(opt_splrate, opt_pcm, "null:");
     break;
   }
 
@@ -866,10 +1599,17 @@ int main(int argc, char *argv[])
   ecode = zz_init(P, opt_tickrate, max_ms);
   if (ecode)
     goto error_exit;
+  if (opt_fast)
+    zz_core_opts((void*)P, 0, ZZ_OPT_SPAN);
+  if (opt_par)
+    zz_core_opts((void*)P, 0, ZZ_OPT_PAR);
   ecode = zz_setup(P, opt_mixerid, out->hz);
   if (ecode)
     goto error_exit;
   zz_core_mute((void*)P, 0xFF, (opt_mute<<4)|opt_ignore);
+  zz_core_pcm((void*)P, opt_pcm);
+  if (opt_stats)
+    zz_core_opts((void*)P, 0, ZZ_OPT_STATS);
 
 #ifndef NO_AO
   if (wavuri)
@@ -883,8 +1623,9 @@ int main(int argc, char *argv[])
     if (ecode)
       goto error_exit;
 
-    dmsg("info: rate:%hu spr:%lu ms:%lu\n",
-	 HU(info.len.rate), LU(info.mix.spr), LU(info.len.ms));
+    dmsg("info: rate:%hu spr:%lu ms:%lu loop:%lu+%lu\n",
+	 HU(info.len.rate), LU(info.mix.spr), LU(info.len.ms),
+	 LU(info.len.loop), LU(info.len.llen));
 
     dmsg("Output via %s to \"%s\"\n", out->name, out->uri);
     imsg("Zing that zong\n"
@@ -915,9 +1656,19 @@ int main(int argc, char *argv[])
     if (*info.tag.ripper)
       imsg("Ripper  : %s\n", info.tag.ripper);
 
+#ifndef NO_THREAD
+    if (opt_ahead) {
+# ifndef NO_AO
+      const int8_t live = opt_outtype == OUT_IS_LIVE;
+# else
+      const int8_t live = 0;
+# endif
+      ecode = ring_play(P, out, opt_ahead, live);
+    } else
+#endif
     do {
       static int32_t pcm[256];
-      zz_i16_t n = sizeof(pcm) >> 2;
+      zz_i16_t n = sizeof(pcm) / ZZ_PCM_SIZE(opt_pcm);
 
       n = zz_play(P,pcm,n);
       if (n < 0) {
@@ -927,8 +1678,8 @@ int main(int argc, char *argv[])
       if (!n)
 	break;
 
-      n <<= 2;
-      if (n != out->write(out,pcm,n))
+      n *= ZZ_PCM_SIZE(opt_pcm);
+      if (n != out_write(out,pcm,n))
 	ecode = ZZ_EOUT;
       else {
 	zz_u32_t pos = zz_position(P) / 1000u;
@@ -945,6 +1696,8 @@ int main(int argc, char *argv[])
       emsg("(%hu) prematured end (ms:%lu) -- %s\n",
 	   HU(ecode), LU(zz_position(P)), songuri);
     }
+    if (opt_stats)
+      print_stats(P);
   }
 
 error_exit:
@@ -94,6 +94,29 @@ enum {
   ZZ_MAP_ADBC,			       /**< (2) Left:A+D Right:B+C. */
 };
 
+/**
+ * Core options (bit-field).
+ */
+enum {
+  ZZ_OPT_SPAN = 1,		 /**< Mix quiet ticks in one go.     */
+  ZZ_OPT_PAR  = 2,		 /**< Resample voices in parallel.   */
+  ZZ_OPT_STATS = 4,		 /**< Collect zz_stats() counters.   */
+};
+
+/**
+ * Output pcm format (interleaved stereo).
+ */
+enum zz_pcm_e {
+  ZZ_PCM_I16,			   /**< (0) 16-bit signed (default). */
+  ZZ_PCM_I32,			   /**< (1) 32-bit signed.           */
+  ZZ_PCM_F32			   /**< (2) 32-bit float (-1..+1).   */
+};
+
+/**
+ * Size of one stereo pcm (in bytes) for a given format.
+ */
+#define ZZ_PCM_SIZE(FMT) ( (FMT) == ZZ_PCM_I16 ? 4 : 8 )
+
 /**
  * Sampler quality.
  */
@@ -114,6 +137,7 @@ typedef struct mixer_s * zz_mixer_t;
 typedef const struct zz_vfs_dri_s * zz_vfs_dri_t;
 typedef zz_err_t (*zz_guess_t)(zz_play_t const, const char *);
 typedef struct zz_info_s zz_info_t;
+typedef struct zz_stats_s zz_stats_t;
 
 /**
  * zingzong info.
@@ -128,6 +152,8 @@ struct zz_info_s {
   struct {
     zz_u16_t	 rate;		    /**< player tick rate (200hz).  */
     zz_u32_t	 ms;		    /**< song duration in ms.       */
+    zz_u32_t	 loop;		    /**< loop point in ms.          */
+    zz_u32_t	 llen;		    /**< loop length in ms (0:n/a). */
   } len;			    /**< replay info.               */
 
   /** mixer info. */
@@ -136,6 +162,7 @@ struct zz_info_s {
     zz_u8_t	 num;	       /**< mixer identifier.               */
     zz_u8_t	 map;	       /**< channel mapping (ZZ_MAP_*).     */
     zz_u16_t	 lr8;	       /**< 0:normal 128:center 256:invert. */
+    zz_u8_t	 pcm;	       /**< pcm format (ZZ_PCM_*).          */
 
     const char * name;	       /**< mixer name or "".               */
     const char * desc;	       /**< mixer description or "".        */
@@ -158,6 +185,42 @@ struct zz_info_s {
 };
 
 
+/**
+ * Cumulative time and count of a player stage.
+ */
+struct zz_stage_s {
+  uint64_t ns;			/**< time spent (in ns).          */
+  uint64_t cnt;			/**< count (@see zz_stats_s).     */
+};
+
+/**
+ * Number of mixer specific counters (@see zz_stats_s).
+ */
+#define ZZ_STATS_MIX 8
+
+/**
+ * zingzong performance statistics (@see zz_stats()).
+ *
+ *   The output is not a library stage; the application times its
+ *   own writes.
+ */
+struct zz_stats_s {
+  struct zz_stage_s tick;	/**< sequencer (cnt:ticks).       */
+  struct zz_stage_s trig;	/**< trigger setup (cnt:pushes).  */
+  struct zz_stage_s voice;	/**< resampling (cnt:voice pcm).  */
+  struct zz_stage_s map;	/**< stereo mapping (cnt:pcm).    */
+  struct zz_stage_s play;	/**< zz_play() (cnt:pcm).         */
+  uint64_t notes;		/**< notes triggered.             */
+  uint64_t clips;		/**< samples at full scale.       */
+  zz_u32_t pcm_max;		/**< peak pcm per tick.           */
+
+  /** Mixer specific counters (named by the mixer). */
+  struct {
+    const char * name;		/**< counter name (0:unused).     */
+    uint64_t cnt;		/**< counter value.               */
+  } mix[ZZ_STATS_MIX];
+};
+
 /* **********************************************************************
  *
  * Low level API (core)
@@ -185,6 +248,39 @@ ZINGZONG_API
  */
 uint8_t zz_core_mute(zz_core_t K, uint8_t clr, uint8_t set);
 
+ZINGZONG_API
+/**
+ * Get/Set core options (@see ZZ_OPT_SPAN ...).
+ *
+ * @param  core  core player
+ * @param  clr   clear these bits
+ * @param  set   set these bits
+ * @return old bits
+ * @notice With ZZ_OPT_SPAN zz_play() merges the ticks without
+ *         sequencer event (no note, no slide) following a tick into
+ *         a single mixer call. The output is unchanged but
+ *         zz_position() is only updated once per span.
+ * @notice ZZ_OPT_PAR is applied by the mixer init (zz_setup()). The
+ *         "soxr" and "sinc" mixers then resample each voice on its own
+ *         thread. The output is unchanged.
+ * @notice ZZ_OPT_STATS times the player stages for zz_stats(). It
+ *         has no effect on builds without statistics (NO_STATS).
+ */
+uint8_t zz_core_opts(zz_core_t K, uint8_t clr, uint8_t set);
+
+ZINGZONG_API
+/**
+ * Get/Set output pcm format.
+ *
+ * @param  core  core player
+ * @param  fmt   pcm format (ZZ_PCM_*, >ZZ_PCM_F32: unchanged)
+ * @return old format
+ * @notice The format applies to the following pcm. Buffers given to
+ *         zz_play() must hold ZZ_PCM_SIZE(fmt) bytes per pcm.
+ * @notice ZZ_PCM_F32 is ignored by builds without float support.
+ */
+uint8_t zz_core_pcm(zz_core_t core, uint8_t fmt);
+
 ZINGZONG_API
 /**
  * Init core player.
@@ -211,7 +307,14 @@ zz_i16_t zz_core_play(zz_core_t core, void * pcm, zz_i16_t n);
 
 ZINGZONG_API
 /**
- * Set channel blending.
+ * Get/Set channel blending.
+ *
+ * @param  core  core player (0: default for players to come)
+ * @param  map   channel mapping (ZZ_MAP_*, >2: unchanged)
+ * @param  lr8   blending (0..256, >256: unchanged)
+ * @return old blending as (lr8<<16)|map
+ * @notice The default is applied by zz_core_init(). It is safe to
+ *         change it while other threads are running players.
  */
 zz_u32_t zz_core_blend(zz_core_t core, zz_u8_t map, zz_u16_t lr8);
 
@@ -253,6 +356,8 @@ ZINGZONG_API
  *
  * @param func  pointer to the new log function (0: to disable all).
  * @param user  pointer user private data (parameter #2 of func).
+ * @notice Set it before any player is running. The log function
+ *         might be called concurrently by several threads.
  */
 void zz_log_fun(zz_log_t func, void * user);
 
@@ -288,6 +393,21 @@ ZINGZONG_API
  */
 void zz_del(zz_play_t * pplay);
 
+ZINGZONG_API
+/**
+ * Allocate the player private memory from an arena.
+ *
+ * Song data, URIs and mixer buffers are then carved out of a few
+ * large blocks sized after the loaded files and released at once
+ * by zz_close(). Shared voice sets are not part of it.
+ *
+ * @param  play  player instance (closed)
+ * @param  size  initial arena size in bytes (0:automatic)
+ * @return error code
+ * @retval ZZ_OK(0) on success
+ */
+zz_err_t zz_arena(zz_play_t play, zz_u32_t size);
+
 
 /* **********************************************************************
  *
@@ -317,6 +437,7 @@ ZINGZONG_API
  * @param  play  player instance
  * @return error code
  * @retval ZZ_OK(0) on success
+ * @notice The player can be reused to load another song.
  */
 zz_err_t zz_close(zz_play_t const play);
 
@@ -372,7 +493,7 @@ ZINGZONG_API
  * Play.
  *
  * @param  play  player instance
- * @param  pcm   pcm buffer (format might depend on mixer).
+ * @param  pcm   pcm buffer (@see zz_core_pcm()).
  * @param  n     >0: number of pcm to fill
  *                0: get number of pcm to complete the tick.
  *               <0: complete the tick but not more than -n pcm.
@@ -384,6 +505,73 @@ ZINGZONG_API
  */
 zz_i16_t zz_play(zz_play_t play, void * pcm, zz_i16_t n);
 
+ZINGZONG_API
+/**
+ * Seek to a play position.
+ *
+ *   The player keeps a checkpoint of its state every few seconds of
+ *   played music. Seeking restores the closest checkpoint before the
+ *   requested position then plays the remaining ticks (without
+ *   output). With a mixer unable to save its state the player
+ *   restarts from the beginning when seeking backward.
+ *
+ * @param  play  player instance
+ * @param  ms    position (in ms)
+ * @return error code
+ * @retval ZZ_OK(0) on success
+ * @notice Call zz_setup() before zz_seek().
+ */
+zz_err_t zz_seek(zz_play_t play, zz_u32_t ms);
+
+ZINGZONG_API
+/**
+ * Fast-forward to a play position.
+ *
+ *   Unlike zz_seek() only the sequencer runs. It jumps from one
+ *   sequencer event to the next, sliding notes in a single step, so
+ *   that the cost depends on the number of events rather than on the
+ *   duration. Voices holding a note at the new position are restarted
+ *   from the beginning of their instrument at their current pitch
+ *   (or stopped if the instrument has changed since); the result is
+ *   a close approximation of a regular play, not an exact one.
+ *   Skipping backward restores a checkpoint (or restarts) first.
+ *
+ * @param  play  player instance
+ * @param  ms    position (in ms)
+ * @return error code
+ * @retval ZZ_OK(0) on success
+ * @notice Call zz_setup() before zz_skip().
+ */
+zz_err_t zz_skip(zz_play_t play, zz_u32_t ms);
+
+/**
+ * Maximum number of threads used by zz_render_parallel().
+ */
+#define ZZ_RENDER_MAX 32
+
+ZINGZONG_API
+/**
+ * Render pcm on several threads.
+ *
+ *   A first pass plays the pcm without mixing them and records the
+ *   player state at the start of each segment. The segments are
+ *   then mixed in parallel and the result is the same as with
+ *   zz_play(). The player is left after the last pcm. Mixers unable
+ *   to skip pcm (or a single segment) render on the calling thread.
+ *
+ * @param  play     player instance
+ * @param  pcm      output buffer (in the player pcm format)
+ * @param  pn       pcm to render; receive the number rendered (less
+ *                  at the end of the music)
+ * @param  threads  number of threads (0: one per CPU, at most
+ *                  ZZ_RENDER_MAX)
+ * @return error code
+ * @retval ZZ_OK(0) on success
+ * @notice Call zz_setup() before zz_render_parallel().
+ */
+zz_err_t zz_render_parallel(zz_play_t play, void * pcm, zz_u32_t * pn,
+			    zz_u8_t threads);
+
 ZINGZONG_API
 /**
  * Get current play position (in ms).
@@ -392,6 +580,21 @@ ZINGZONG_API
  */
 zz_u32_t zz_position(zz_play_t play);
 
+ZINGZONG_API
+/**
+ * Get or reset performance statistics.
+ *
+ * @param  play   player instance
+ * @param  stats  receive the statistics (0:reset them)
+ * @return error code
+ * @retval ZZ_OK(0) on success
+ * @retval ZZ_ERR if the build has no statistics (NO_STATS)
+ * @notice Statistics are only collected with ZZ_OPT_STATS (@see
+ *         zz_core_opts()). They are cumulative since zz_new() or
+ *         the last reset.
+ */
+zz_err_t zz_stats(zz_play_t play, zz_stats_t * stats);
+
 ZINGZONG_API
 /**
  * Get info mixer info.
@@ -422,6 +625,21 @@ struct mixer_s {
 
   /** Push PCM function. */
   zz_i16_t (*push)(zz_core_t const, void *, zz_i16_t);
+
+  /** Save mixer state function (optional). Returns the state size
+   *  (nothing is written when the buffer is 0). */
+  zz_u32_t (*save)(zz_core_t const, void *);
+
+  /** Restore mixer state function (optional). */
+  void (*restore)(zz_core_t const, const void *);
+
+  /** Skip PCM function (optional). Same as push without mixing,
+   *  the state is left as if the PCM had been pushed. */
+  zz_i16_t (*skip)(zz_core_t const, zz_i16_t);
+
+  /** Names of the zz_stats_s::mix counters (optional, 0 terminated,
+   *  up to ZZ_STATS_MIX). */
+  const char * const * stats;
 };
 
 /* **********************************************************************
@@ -454,6 +672,14 @@ struct zz_vfs_dri_s {
   zz_u32_t (*tell)(zz_vfs_t);			/**< get position.  */
   zz_u32_t (*size)(zz_vfs_t);			/**< get size.      */
   zz_err_t (*seek)(zz_vfs_t,zz_u32_t,zz_u8_t);	/**< offset,whence. */
+
+  /**
+   * Map n bytes at the current position followed by x zeroed bytes
+   * (optional). Returns a private writable address or 0 to read
+   * instead. The position moves past the n bytes.
+   */
+  void *   (*map)(zz_vfs_t, zz_u32_t, zz_u32_t);
+  void	   (*unmap)(void *, zz_u32_t, zz_u32_t); /**< unmap(ptr,n,x). */
 };
 
 /**
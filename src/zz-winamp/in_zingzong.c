@@ -102,6 +102,7 @@ static int32_t	 g_pcm[576*2];		/* buffer for DSP filters  */
 static volatile LONG g_playing;		/* true while playing      */
 static volatile LONG g_stopreq;		/* stop requested          */
 static volatile LONG g_paused;		/* pause status            */
+static volatile LONG g_seekreq = -1;	/* seek request (ms)       */
 
 /*****************************************************************************
  * Declaration
@@ -183,7 +184,7 @@ In_Module g_mod =
   "qts\0"  "Quartet score (*.qts)\0"
   "qta\0"  "Quartet score (*.qta)\0"
   ,
-  0,				      /* is_seekable */
+  1,				      /* is_seekable */
   1,				      /* uses output plug-in system */
 
   config,
@@ -333,7 +334,8 @@ static
  ****************************************************************************/
 void setoutputtime(int ms)
 {
-  /* Not supported ATM. */
+  /* Handled by the decode thread. */
+  atomic_set(&g_seekreq, ms < 0 ? 0 : ms);
 }
 
 static
@@ -509,6 +511,7 @@ int play(const char * uri)
   g_maxlatency = 0;
   g_stopreq    = 0;
   g_paused     = 0;
+  g_seekreq    = -1;
 
   /* Load and initialize file */
   err = -1;
@@ -650,6 +653,7 @@ DWORD WINAPI playloop(LPVOID cookie)
   zz_u8_t filling = 1;
   zz_u16_t npcm = 0, n;
   int32_t * _pcm;
+  LONG ms;
 
   atomic_set(&g_playing,1);
   for (;;) {
@@ -657,6 +661,15 @@ DWORD WINAPI playloop(LPVOID cookie)
     if (atomic_get(&g_stopreq))
       break;
 
+    ms = atomic_set(&g_seekreq,-1);
+    if (ms >= 0) {
+      if (zz_seek(&g_play, ms))
+	break;
+      g_mod.outMod->Flush(zz_position(&g_play));
+      npcm = 0;
+      filling = 1;
+    }
+
     if (filling) {
       /* filling */
       n = 576 - npcm;
@@ -11,9 +11,13 @@
 void
 bin_free(bin_t ** pbin)
 {
-  if (pbin && *pbin)
-    dmsg("free <%p>:%lu:%lu\n",
-         (*pbin), LU((*pbin)->len), LU((*pbin)->max));
+  if (pbin && *pbin) {
+    bin_t * const bin = *pbin;
+    dmsg("free <%p>:%lu:%lu%s\n",
+         bin, LU(bin->len), LU(bin->max), bin->dri ? " (mapped)" : "");
+    if (bin->dri)
+      bin->dri->unmap(bin->ptr, bin->len, bin->max - bin->len);
+  }
   zz_free(pbin);
 }
 
@@ -39,6 +43,7 @@ bin_alloc(bin_t ** pbin, u32_t len, u32_t xlen)
     bin->ptr = bin->_buf;
     bin->max = size;
     bin->len = len;
+    bin->dri = 0;
   } while (0);
 
   dmsg("<%p..%p> %lu/%lu/%lu\n",
@@ -57,10 +62,35 @@ bin_read(bin_t * bin, vfs_t vfs, u32_t off, u32_t len)
     ;
 }
 
+/* GB: Use the file data in place when the VFS can map it. Pages are
+ *     private so writing into them (unroll, mixer extra pcm) copies
+ *     only the touched pages. Returns non zero if mapped (or if the
+ *     position has moved anyway).
+ */
+static int
+bin_map(bin_t ** pbin, vfs_t vfs, u32_t len, u32_t xlen, zz_err_t * pecode)
+{
+  uint8_t * const ptr = vfs_map(vfs, len, xlen);
+
+  if (!ptr)
+    return 0;
+  if ( (*pecode = zz_malloc(pbin, sizeof(bin_t))) )
+    vfs->dri->unmap(ptr, len, xlen);
+  else {
+    bin_t * const bin = *pbin;
+    bin->ptr = ptr;
+    bin->max = len + xlen;
+    bin->len = len;
+    bin->dri = vfs->dri;
+    dmsg("<%p> mapped %lu/%lu\n", bin, LU(len), LU(xlen));
+  }
+  return 1;
+}
+
 zz_err_t
 bin_load(bin_t ** pbin, vfs_t vfs, u32_t len, u32_t xlen, u32_t max)
 {
-  int ecode;
+  zz_err_t ecode;
 
   ecode = E_ARG;
   if (!vfs || ! pbin)
@@ -87,6 +117,8 @@ bin_load(bin_t ** pbin, vfs_t vfs, u32_t len, u32_t xlen, u32_t max)
     goto error;
   }
 
+  if (bin_map(pbin, vfs, len, xlen, &ecode))
+    goto error;
   ecode = bin_alloc(pbin, len, xlen);
   if (ecode)
     goto error;
@@ -27,35 +27,37 @@ static uint8_t chan_maps[3][4] = {
   /* ZZ_MAP_ADBC */ { 0,2,3,1 }  /* A C D B */
 };
 
-zz_u8_t  zz_chan_map = ZZ_MAP_ABCD;
-zz_u16_t zz_chan_lr8 = BLEND_DEF;
+/* Default blending for new players: (lr8<<16)|map. Packed in a
+ * single word so that it is always read and written as a whole. */
+static zz_u32_t chan_blend = ( (zz_u32_t) BLEND_DEF << 16 ) | ZZ_MAP_ABCD;
 
 zz_u32_t
 zz_core_blend(core_t * K, zz_u8_t map, zz_u16_t lr8)
 {
-  zz_u32_t old
-    = !K
-    ? ( (zz_u32_t) zz_chan_lr8 << 16 ) | zz_chan_map
-    : ( (zz_u32_t) K->lr8 << 16 ) | K->cmap
-    ;
-
-  if (map <= 2u) {
-    if (!K)
-      zz_chan_map = map;
-    else {
-      u8_t k;
-      K->cmap = map;
-      for (k=0; k<4; ++k)
-        K->chan[k].pam = chan_maps[map][k];
-    }
+  zz_u32_t old;
+
+  if (!K) {
+    zz_u32_t set;
+    old = zz_atomic_get(&chan_blend);
+    do {
+      set = old;
+      if (map <= 2u)
+        set = ( set & ~0xFFFFu ) | map;
+      if (lr8 <= 256u)
+        set = ( set & 0xFFFFu ) | ( (zz_u32_t) lr8 << 16 );
+    } while (set != old && !zz_atomic_cas(&chan_blend, &old, set));
+    return old;
   }
 
-  if (lr8 <= 256u) {
-    if (!K)
-      zz_chan_lr8 = lr8;
-    else
-      K->lr8 = lr8;
+  old = ( (zz_u32_t) K->lr8 << 16 ) | K->cmap;
+  if (map <= 2u) {
+    u8_t k;
+    K->cmap = map;
+    for (k=0; k<4; ++k)
+      K->chan[k].pam = chan_maps[map][k];
   }
+  if (lr8 <= 256u)
+    K->lr8 = lr8;
 
 #ifndef NDEBUG
   if (K) {
@@ -87,6 +89,27 @@ zz_core_mute(core_t * K, uint8_t clr, uint8_t set)
   return old;
 }
 
+uint8_t
+zz_core_opts(core_t * K, uint8_t clr, uint8_t set)
+{
+  const uint8_t old = K->opts;
+  K->opts = (K->opts & ~clr) | set;
+  return old;
+}
+
+uint8_t
+zz_core_pcm(core_t * K, uint8_t fmt)
+{
+  const uint8_t old = K->pcmfmt;
+#ifdef NO_FLOAT
+  if (fmt == ZZ_PCM_F32)
+    fmt = old;
+#endif
+  if (fmt <= ZZ_PCM_F32)
+    K->pcmfmt = fmt;
+  return old;
+}
+
 /* ---------------------------------------------------------------------- */
 
 /* Offset between 2 sequences (should be multiple of 12). */
@@ -302,10 +325,12 @@ zz_err_t
 zz_core_tick(core_t * const K)
 {
   chan_t * C;
+  STATS_START(K,t);
   ++ K->tick;
   K->loop &= 0x0F;                     /* clear non-persistent part */
   for ( C=K->chan; C<K->chan+4; ++C )
     zz_core_chan(K,C);
+  STATS_STAGE(K,tick,t,1);
   return K->code;
 }
 
@@ -346,7 +371,9 @@ zz_core_kill(core_t * K)
 {
   if (K) {
     if (K->mixer) {
+      arena_t * const old = arena_use(K->arena);
       K->mixer->free(K);
+      arena_use(old);
       K->mixer = 0;
       K->data  = 0;
     }
@@ -421,7 +448,10 @@ zz_core_init(core_t * K, mixer_t * M, u32_t spr)
     C->cur = C->seq = K->song.seq[k];
     C->loop_sp = C->loops;
   }
-  zz_core_blend(K, zz_chan_map, zz_chan_lr8);
+  if (1) {
+    const zz_u32_t blend = zz_atomic_get(&chan_blend);
+    zz_core_blend(K, blend & 0xFFFFu, blend >> 16);
+  }
   K->loop = 0x0F & K->mute; /* set ignored voices */
   K->tick = 0;
 
@@ -430,9 +460,11 @@ zz_core_init(core_t * K, mixer_t * M, u32_t spr)
   else if (!M)
     ecode = E_MIX;
   else {
+    arena_t * const old = arena_use(K->arena);
     K->spr = 0;
     K->mixer = M;
     ecode = M->init(K, spr);
+    arena_use(old);
   }
 
   return K->code = ecode;
@@ -79,6 +79,7 @@
 # define zz_log_wrn(FMT,...) zz_void
 # define zz_log_inf(FMT,...) zz_void
 # define zz_log_dbg(FMT,...) zz_void
+# define zz_log_quiet(CLR,SET) 0
 
 #else
 
@@ -107,6 +108,8 @@ ZZ_EXTERN_C FMT12 void
 zz_log_inf(const char * fmt,...);
 ZZ_EXTERN_C FMT12 void
 zz_log_dbg(const char * fmt,...);
+ZZ_EXTERN_C zz_u8_t
+zz_log_quiet(const zz_u8_t clr, const zz_u8_t set);
 #endif /* NO_LOG */
 
 #ifndef ZZ_ERR_PREFIX
@@ -215,6 +218,7 @@ struct zz_out_s {
   const char * name;			/**< friendly name.  */
   const char * uri;			/**< uri/path. */
   zz_u32_t     hz;			/**< sampling rate. */
+  zz_u8_t      fmt;			/**< pcm format (ZZ_PCM_*). */
 
   /** Close and free function. */
   zz_err_t (*close)(zz_out_t *);
@@ -224,9 +228,11 @@ struct zz_out_s {
 };
 
 ZZ_EXTERN_C
-zz_out_t * out_ao_open(zz_u32_t hz, const char * uri);
+zz_out_t * out_ao_open(zz_u32_t hz, zz_u8_t fmt, const char * uri);
 ZZ_EXTERN_C
-zz_out_t * out_raw_open(zz_u32_t hz, const char * uri);
+zz_out_t * out_raw_open(zz_u32_t hz, zz_u8_t fmt, const char * uri);
+ZZ_EXTERN_C
+zz_out_t * out_wav_open(zz_u32_t hz, zz_u8_t fmt, const char * uri);
 /**
  * @}
  */
@@ -110,6 +110,270 @@ static void collapse_all(loop_stack_t loops, u8_t ssp)
     ssp = collapse_one(loops, ssp, 0);
 }
 
+#ifndef ZZ_MINIMAL
+
+/* ----------------------------------------------------------------------
+ * Sequencer simulation (song length and loop point)
+ * ----------------------------------------------------------------------
+ */
+
+#ifndef SCAN_PASS
+# define SCAN_PASS 8		     /* max passes per channel.      */
+#endif
+#define SCAN_CMDS  (1ul<<22)	     /* max commands per channel.    */
+#define SCAN_TICKS (1ul<<22)	     /* max loop point+length.       */
+
+typedef struct scan_s scan_t;
+
+/** Channel state that matters to the sequencer. */
+struct scan_s {
+  note_t note;			/**< note (ins unused).            */
+  u8_t	 curi;			/**< current instrument.           */
+  u8_t	 inum;			/**< instrument of the note.       */
+};
+
+enum {
+  SCAN_CURI = 1,		/* instrument used before set.   */
+  SCAN_NOTE = 2,		/* note slides before any reset. */
+};
+
+/* Compare the state that matters to what follows. */
+static int scan_same(const scan_t * a, const scan_t * b, u8_t live)
+{
+  return 1
+    && ( !(live & SCAN_CURI) || a->curi == b->curi )
+    && ( !(live & SCAN_NOTE)
+         || ( a->note.cur == b->note.cur
+              && a->note.stp == b->note.stp
+              && (!a->note.stp || a->note.aim == b->note.aim)
+              && (!a->note.cur || a->inum == b->inum) ) );
+}
+
+static u32_t gcd32(u32_t a, u32_t b)
+{
+  while (b) {
+    const u32_t r = a % b;
+    a = b; b = r;
+  }
+  return a;
+}
+
+/* Number of portamento ticks (less than wait) after which two states
+ * are the same (ZZ_EOF if none). */
+static u32_t scan_meet(const scan_t * S, u16_t wait)
+{
+  const u8_t all = SCAN_CURI|SCAN_NOTE;
+  u16_t lo = 1, hi = wait-1;
+  scan_t a, b;
+
+  if (scan_same(S+0, S+1, all))
+    return 0;
+  if (wait < 2)
+    return ZZ_EOF;
+  a = S[0]; note_slide(&a.note, hi);
+  b = S[1]; note_slide(&b.note, hi);
+  if (!scan_same(&a, &b, all))
+    return ZZ_EOF;
+  while (lo < hi) {
+    const u16_t mi = (lo+hi) >> 1;
+    a = S[0]; note_slide(&a.note, mi);
+    b = S[1]; note_slide(&b.note, mi);
+    if (scan_same(&a, &b, all))
+      hi = mi;
+    else
+      lo = mi+1;
+  }
+  return lo;
+}
+
+/* Run one pass of a channel sequence the same way zz_core_chan() does
+ * but one command at a time instead of one tick at a time. The pass
+ * is run for n states in lockstep. With 2 states *meet receives the
+ * number of ticks before the first tick after which they are equal.
+ *
+ * @return pass length in ticks (0 on error)
+ */
+static u32_t
+scan_pass(const sequ_t * const org, scan_t * S, u8_t n,
+          u32_t * budget, u8_t * live, u32_t * meet)
+{
+  struct loop_s loops[MAX_LOOP], *sp = loops, *l;
+  const sequ_t * seq = org;
+  u32_t ticks = 0;
+  u8_t dead = 0, k;
+
+  for (;; ++seq) {
+    u16_t const cmd = U16(seq->cmd);
+    u16_t const len = U16(seq->len);
+    u32_t const stp = U32(seq->stp);
+    u32_t const par = U32(seq->par);
+    u16_t wait = 0;
+
+    if (!*budget)
+      return 0;
+    --*budget;
+
+    switch (cmd) {
+    case 'F':
+      return ticks;
+    case 'V':
+      dead |= SCAN_CURI;
+      for (k=0; k<n; ++k)
+        S[k].curi = par >> 2;
+      break;
+    case 'P':
+      *live |= SCAN_CURI & ~dead;
+      dead |= SCAN_NOTE;
+      for (k=0; k<n; ++k) {
+        S[k].inum = S[k].curi;
+        S[k].note.cur = S[k].note.aim = stp;
+        S[k].note.stp = 0;
+      }
+      wait = len;
+      break;
+    case 'S':
+      *live |= (SCAN_CURI|SCAN_NOTE) & ~dead;
+      dead |= SCAN_NOTE;
+      for (k=0; k<n; ++k) {
+        if (!S[k].note.cur) {
+          S[k].inum = S[k].curi;
+          S[k].note.cur = stp;
+        }
+        S[k].note.aim = stp;
+        S[k].note.stp = (int32_t) par;
+      }
+      wait = len;
+      break;
+    case 'R':
+      dead |= SCAN_NOTE;
+      for (k=0; k<n; ++k) {
+        S[k].note.stp = 0;
+        S[k].note.cur = 0;
+      }
+      wait = len;
+      break;
+    case 'l':
+      if (sp >= loops+MAX_LOOP)
+        return 0;
+      sp->off = seq + 1 - org;
+      sp->cnt = 0;
+      ++sp;
+      break;
+    case 'L':
+      l = sp-1;
+      if (l < loops) {
+        sp = (l = loops) + 1;
+        l->cnt = 0;
+        l->off = 0;
+      }
+      if ( ( l->cnt = l->cnt ? l->cnt-1 : (par >> 16) ) )
+        seq = org + l->off - 1;
+      else
+        --sp;
+      break;
+    default:
+      return 0;
+    }
+
+    if (wait) {
+      if (n == 2 && *meet == ZZ_EOF) {
+        const u32_t m = scan_meet(S, wait);
+        if (m != ZZ_EOF)
+          *meet = ticks + m;
+      }
+      /* Portamento runs on the next wait ticks. */
+      for (k=0; k<n; ++k)
+        if (S[k].note.stp)
+          note_slide(&S[k].note, wait);
+      ticks += wait;
+      if (ticks > SCAN_TICKS)
+        return 0;
+    }
+  }
+}
+
+/* Find where the sequencer state of every channel repeats.
+ *
+ *   Each channel is run pass after pass until the state at the start
+ *   of a pass matches the one of a previous pass. The loop point of
+ *   the channel is then refined by running the pass before both in
+ *   lockstep. The song loops when all channels do, the loop length
+ *   is the least common multiple of the channel loop lengths.
+ */
+static void
+song_scan(song_t * song)
+{
+  u32_t end = 0, lpos = 0, llen = 1;
+  u8_t k;
+
+  for (k=0; k<4; ++k) {
+    scan_t st[SCAN_PASS+1];
+    u32_t  at[SCAN_PASS+1], budget = SCAN_CMDS, len, pos;
+    u8_t   n, i = 0, live = 0;
+
+    zz_memclr(st, sizeof(st[0]));
+    at[0] = 0;
+    for (n=1; n<=SCAN_PASS; ++n) {
+      st[n] = st[n-1];
+      len = scan_pass(song->seq[k], st+n, 1, &budget, &live, 0);
+      if (!len || len > SCAN_TICKS - at[n-1]) {
+        i = n;
+        break;
+      }
+      at[n] = at[n-1] + len;
+      for (i=0; i<n && !scan_same(st+i, st+n, live); ++i)
+        ;
+      if (i < n)
+        break;
+    }
+
+    if (n == 1 && i == n) {
+      dmsg("%c simulation failed\n", 'A'+k);
+      return;
+    }
+    if (at[1] > end)
+      end = at[1];
+
+    if (n > SCAN_PASS || i == n) {
+      dmsg("%c no loop found after %hu passes\n", 'A'+k, HU(n-1));
+      llen = 0;
+      continue;
+    }
+
+    len = at[n] - at[i];
+    pos = at[i];
+    if (i > 0) {
+      scan_t two[2];
+      u32_t meet = ZZ_EOF;
+      two[0] = st[i-1];
+      two[1] = st[n-1];
+      if (scan_pass(song->seq[k], two, 2, &budget, &live, &meet)
+          && meet != ZZ_EOF)
+        pos = at[i-1] + meet;
+    }
+    dmsg("%c pass:%lu loop:%lu+%lu\n", 'A'+k, LU(at[1]), LU(pos), LU(len));
+
+    if (pos > lpos)
+      lpos = pos;
+    if (llen) {
+      const u32_t f = llen / gcd32(llen,len);
+      llen = len > SCAN_TICKS / f ? 0 : f * len;
+    }
+  }
+
+  if (end != song->ticks)
+    dmsg("song length estimated:%lu simulated:%lu ticks\n",
+         LU(song->ticks), LU(end));
+  song->ticks = end;
+  if (llen && lpos + llen <= SCAN_TICKS) {
+    song->lpos = lpos;
+    song->llen = llen;
+  }
+  dmsg("song loop: %lu+%lu ticks\n", LU(song->lpos), LU(song->llen));
+}
+
+#endif /* ZZ_MINIMAL */
+
 zz_err_t
 song_init(song_t * song)
 {
@@ -132,7 +396,7 @@ song_init(song_t * song)
   song->seq[0] = song->seq[1] = song->seq[2] = song->seq[3] = 0;
   song->stepmin = song->stepmax = 0;
   song->iuse = song->iref = 0;
-  song->ticks = 0;
+  song->ticks = song->lpos = song->llen = 0;
 
   /* Basic parsing of the sequences to find the end. It replaces
    * empty sequences by something that won't loop endlessly and won't
@@ -296,6 +560,9 @@ song_init(song_t * song)
   dmsg("song steps: %08lx .. %08lx\n", LU(song->stepmin), LU(song->stepmax));
   dmsg("song instruments: used: %05lx referenced:%05lx difference:%05lx\n",
        LU(song->iuse), LU(song->iref), LU(song->iref^song->iuse));
+#ifndef ZZ_MINIMAL
+  song_scan(song);
+#endif
   ecode = E_OK;
 
 error:
@@ -67,14 +67,16 @@ vset_guess(zz_play_t const P, const char * songuri)
 
 #else /* NO_LIBC */
 
+#include <dirent.h>
+
 static zz_err_t
 try_vset_load(vset_t * vset, const char * uri)
 {
-  const zz_u8_t old_log = zz_log_bit(1<<ZZ_LOG_ERR,0);
+  const zz_u8_t old_log = zz_log_quiet(0,1<<ZZ_LOG_ERR);
   zz_err_t ecode;
   dmsg("try set -- \"%s\"\n", uri);
   ecode = vset_load(vset, uri);
-  zz_log_bit(0, old_log & (1<<ZZ_LOG_ERR)); /* restore ZZ_LOG_ERROR  */
+  zz_log_quiet(1<<ZZ_LOG_ERR, old_log & (1<<ZZ_LOG_ERR)); /* restore */
   if (ecode)
     dmsg("unable to load voice set (%hu) -- \"%s\"\n", HU(ecode), uri);
   return ecode;
@@ -107,6 +109,176 @@ fileext(const char * const s)
   return s+l;
 }
 
+/* ----------------------------------------------------------------------
+ * Voice set candidates
+ * ----------------------------------------------------------------------
+ */
+
+#define GUESS_MAX 32			/* max candidates */
+
+typedef struct guess_s guess_t;
+struct guess_s {
+  char * buf;				/* 2*GUESS_MAX+1 names of len bytes */
+  int    len;				/* name buffer size */
+  int    cnt;				/* number of candidates */
+  u8_t   idx[GUESS_MAX];		/* candidates in trying order */
+};
+
+static inline char *
+guess_name(const guess_t * G, int i)
+{
+  return G->buf + mulu32(G->len, i);
+}
+
+/* Listed name of a candidate (case-folded match). */
+static inline char *
+guess_real(const guess_t * G, int i)
+{
+  return guess_name(G, GUESS_MAX+1+i);
+}
+
+static void
+guess_add(guess_t * G, const char * s)
+{
+  int i;
+
+  for (i=0; i<G->cnt; ++i)
+    if (!strcmp(s, guess_name(G,i)))
+      return;
+  if (G->cnt >= GUESS_MAX) {
+    dmsg("too many candidates -- \"%s\"\n", s);
+    return;
+  }
+  strcpy(guess_name(G,G->cnt), s);
+  G->idx[G->cnt] = G->cnt;
+  ++G->cnt;
+}
+
+/* Keep the candidates found in the directory and give them their real
+ * name. The candidates are indexed by case-folded basename so that
+ * each entry costs a binary search. Nothing is removed if the
+ * directory can not be listed (e.g. not a local file).
+ */
+static void
+guess_list(guess_t * G, const char * songuri, const int inud)
+{
+  char * const dir = guess_name(G, GUESS_MAX); /* spare slot */
+  u8_t ord[GUESS_MAX], hit[GUESS_MAX];
+  struct dirent * de;
+  DIR * dd;
+  int i, j;
+
+  if (!G->cnt)
+    return;
+  zz_memcpy(dir, songuri, inud);
+  strcpy(dir+inud, inud ? "" : ".");
+  if ( ! (dd = opendir(dir)) ) {
+    dmsg("unable to list -- \"%s\"\n", dir);
+    return;
+  }
+
+  /* Index (stable insertion sort, there are only a few). */
+  for (i=0; i<G->cnt; ++i) {
+    const char * const b = guess_name(G,i) + inud;
+    for (j=i; j>0 && strcasecmp(guess_name(G,ord[j-1])+inud, b) > 0; --j)
+      ord[j] = ord[j-1];
+    ord[j] = i;
+    hit[i] = 0;
+  }
+
+  while ( !!(de = readdir(dd)) ) {
+    const char * const name = de->d_name;
+    int lo = 0, hi = G->cnt, k = -1, x = -1;
+
+    if (inud + strlen(name) >= (unsigned) G->len)
+      continue;
+    while (lo < hi) {
+      const int m = (lo+hi) >> 1;
+      if (strcasecmp(guess_name(G,ord[m])+inud, name) < 0)
+	lo = m+1;
+      else
+	hi = m;
+    }
+
+    /* GB: Within a case-folded group an exact name owns its slot.
+     *     Other entries take the first free slot and are moved away
+     *     if the exact name shows up later.
+     */
+    for (; lo < G->cnt && !strcasecmp(guess_name(G,ord[lo])+inud, name); ++lo) {
+      const int o = ord[lo];
+      if (x < 0 && !strcmp(guess_name(G,o)+inud, name))
+	x = o;
+      else if (k < 0 && !hit[o])
+	k = o;
+    }
+    if (x >= 0 && hit[x] == 2 && k >= 0) {
+      zz_memcpy(guess_real(G,k), guess_real(G,x), strlen(guess_real(G,x))+1);
+      hit[k] = 2;
+    }
+    if (x >= 0)
+      hit[x] = 1;
+    else if (k >= 0) {
+      strcpy(guess_real(G,k), name);
+      hit[k] = 2;
+    }
+  }
+  closedir(dd);
+
+  for (i=j=0; i<G->cnt; ++i) {
+    const int k = G->idx[i];
+    if (hit[k] == 2)
+      strcpy(guess_name(G,k)+inud, guess_real(G,k));
+    if (hit[k])
+      G->idx[j++] = k;
+  }
+  dmsg("%d/%d candidates listed in -- \"%s\"\n", j, G->cnt, dir);
+  G->cnt = j;
+}
+
+/* Compatibility of a voice set header with the song (-1:invalid). */
+static int
+guess_score(const song_t * song, const char * uri)
+{
+  const zz_u8_t old_log = zz_log_quiet(0,1<<ZZ_LOG_ERR);
+  uint8_t hd[222];
+  vset_t vset;
+  vfs_t vfs = 0;
+  int score = -1;
+
+  if ( 1
+       && E_OK == vfs_open_uri(&vfs,uri)
+       && E_OK == vfs_read_exact(vfs,hd,222)
+       && E_OK == vset_init_header(&vset,hd) ) {
+    score = 0;
+    if ( ! (song->iref >> vset.nbi) )
+      score += 2;			/* has all referenced instruments */
+    if ( vset.khz == song->khz )
+      score += 1;			/* same sampling rate */
+  }
+  vfs_del(&vfs);
+  zz_log_quiet(1<<ZZ_LOG_ERR, old_log & (1<<ZZ_LOG_ERR)); /* restore */
+  dmsg("score %d -- \"%s\"\n", score, uri);
+  return score;
+}
+
+/* Order candidates by decreasing score (stable), drop invalid ones. */
+static void
+guess_rank(guess_t * G, const song_t * song)
+{
+  i8_t score[GUESS_MAX];
+  int i, j, n;
+
+  for (i=n=0; i<G->cnt; ++i) {
+    const u8_t k = G->idx[i];
+    if ( (score[k] = guess_score(song, guess_name(G,k))) < 0 )
+      continue;
+    for (j=n++; j>0 && score[G->idx[j-1]] < score[k]; --j)
+      G->idx[j] = G->idx[j-1];
+    G->idx[j] = k;
+  }
+  G->cnt = n;
+}
+
 static zz_err_t
 vset_guess(zz_play_t P, const char * songuri)
 {
@@ -118,6 +290,7 @@ vset_guess(zz_play_t P, const char * songuri)
   int inud, idot;
   int i, c, tr;
   int idx, next_idx, method, next_method;
+  guess_t G;
 
   enum {
     e_type_ok = 1,		      /* have extension  */
@@ -190,6 +363,13 @@ vset_guess(zz_play_t P, const char * songuri)
   P->vseturi = zz_strnew(songlen+32);
   if (unlikely(!P->vseturi))
     return E_MEM;
+  G.buf = 0;
+  G.len = songlen+32;
+  G.cnt = 0;
+  if (zz_malloc(&G.buf, mulu32(G.len, 2*GUESS_MAX+1))) {
+    zz_strdel(&P->vseturi);
+    return E_MEM;
+  }
 
   for (idx=0, method=1; method ; method=next_method, idx=next_idx) {
     char * const s = P->vseturi->ptr;
@@ -330,15 +510,30 @@ vset_guess(zz_play_t P, const char * songuri)
     if (*s) {
       dmsg("method: #%hi:%hu, next: #%hi:%hu tr:%02hx\n",
 	   HI(method), HU(idx), HI(next_method), HU(next_idx), HU(tr));
-      if (E_OK == try_vset_load(&P->core.vset, s))
-	return E_OK;
+      guess_add(&G, s);
+    }
+  }
+
+  /* GB: Nothing has been opened so far. List the directory once to
+   *     keep the candidates that actually exist (with their real
+   *     name) then rank them by reading their header only.
+   */
+  guess_list(&G, songuri, inud);
+  guess_rank(&G, &P->core.song);
+
+  for (i=0; i<G.cnt; ++i) {
+    const char * const name = guess_name(&G, G.idx[i]);
+    if (E_OK == try_vset_load(&P->core.vset, name)) {
+      strcpy(P->vseturi->ptr, name);
+      zz_free(&G.buf);
+      return E_OK;
     }
   }
+  zz_free(&G.buf);
 
   emsg("unable to find a voice set for -- \"%s\"\n", songuri);
 
-  if (P->core.vset.bin)
-    bin_free(&P->core.vset.bin);
+  vset_release(&P->core.vset);
   zz_assert( ! P->core.vset.bin );
 
   if (P->vseturi)
@@ -355,13 +550,18 @@ zz_err_t (*zz_guess_vset)(zz_play_t const, const char *) = vset_guess;
 zz_err_t
 vset_parse(vset_t *vset, vfs_t vfs, uint8_t *hd, u32_t size)
 {
+  /* Voice sets may be shared and outlive the player. */
+  arena_t * const old = arena_use(0);
   zz_err_t ecode;
   if (0
       /* Parse header and instruments */
       || (ecode = vset_init_header(vset, hd))
       || (ecode = bin_load(&vset->bin, vfs, size, VSET_EXTRA, VSET_MAX_SIZE))
-      || (ecode = vset_init(vset)))
+      || (ecode = vset_init(vset))
+      /* Use the shared copy if any */
+      || (ecode = vset_share(vset)))
     bin_free(&vset->bin);
+  arena_use(old);
   return ecode;
 }
 
@@ -617,12 +817,14 @@ zz_load(play_t * P, const char * songuri, const char * vseturi, zz_u8_t * pfmt)
   zz_err_t ecode;
   zz_u8_t format = ZZ_FORMAT_UNKNOWN;
   const u8_t without_vset = vseturi && !*vseturi;
+  arena_t * old;
 
   dmsg("load: song:<%s>\n", songuri?songuri:"(nil)");
   dmsg("%s: vset:<%s>\n", without_vset?"skip":"load", vseturi?vseturi:"(auto)");
 
   if (!P || !songuri || !*songuri)
     return E_ARG;
+  old = arena_use(P->core.arena);
 
   do {
 
@@ -642,6 +844,7 @@ zz_load(play_t * P, const char * songuri, const char * vseturi, zz_u8_t * pfmt)
 	break;
 
       format = ZZ_FORMAT_4Q;
+      arena_reserve(P->core.arena, U32(hd+8) + U32(hd+16));
       ecode = E_SYS;
       zz_assert ( ! P->songuri );
       zz_assert ( ! P->vseturi );
@@ -668,6 +871,8 @@ zz_load(play_t * P, const char * songuri, const char * vseturi, zz_u8_t * pfmt)
     }
 
     /* Load song */
+    if (vfs_size(inp) != ZZ_EOF)
+      arena_reserve(P->core.arena, vfs_size(inp));
     ecode = song_parse(&P->core.song, inp, hd, 0);
     if (unlikely(ecode))
       break;
@@ -712,6 +917,7 @@ zz_load(play_t * P, const char * songuri, const char * vseturi, zz_u8_t * pfmt)
   P->format = format;
   if (pfmt)
     *pfmt = format;
+  arena_use(old);
 
   return ecode;
 }
@@ -23,22 +23,37 @@ void zz_log_fun(zz_log_t func, void * user) {}
 # endif
 #endif
 
-static zz_u8_t  log_mask = (zz_u8_t) ZZ_LOG_CHANNELS;
+static uint8_t  log_mask = (zz_u8_t) ZZ_LOG_CHANNELS;
 static zz_log_t log_func;
 static void    *log_user;
 
+/* Channels silenced by the calling thread (see zz_log_quiet()). */
+static ZZ_TLS uint8_t log_quiet;
+
 static inline zz_u8_t can_log(const zz_u8_t channel)
 {
-  return log_func && ( log_mask & ( 1 << channel ) );
+  return log_func
+    && ( zz_atomic_get(&log_mask) & ~log_quiet & ( 1 << channel ) );
 }
 
 zz_u8_t zz_log_bit(const zz_u8_t clr, const zz_u8_t set)
 {
-  uint8_t old_mask = log_mask;          /* uint8_t is truly 8-bit */
-  log_mask = ( log_mask & ~clr ) | set;
+  uint8_t old_mask = zz_atomic_get(&log_mask); /* uint8_t is truly 8-bit */
+  while (!zz_atomic_cas(&log_mask, &old_mask,
+                        (uint8_t) ( ( old_mask & ~clr ) | set )))
+    ;
   return old_mask;
 }
 
+/* Same as zz_log_bit() but only for the calling thread and it works
+ * the other way around (set bits are silenced channels). */
+zz_u8_t zz_log_quiet(const zz_u8_t clr, const zz_u8_t set)
+{
+  const uint8_t old_quiet = log_quiet;
+  log_quiet = ( log_quiet & ~clr ) | set;
+  return old_quiet;
+}
+
 void zz_log_fun(zz_log_t func, void * user)
 {
   log_func = func;
@@ -13,6 +13,11 @@
  * - zz_memnew(size,clear)
  * - zz_memdel(ptr)
  *
+ * Private functions:
+ *
+ * - arena_new(size) arena_del() arena_reserve(size)
+ * - arena_reset() arena_use()
+ *
  * These functions are exported. However if NO_LIBC is defined they
  * will issue a warning on call.
  *
@@ -79,9 +84,12 @@ typedef struct {
 
 zz_err_t zz_memchk_calls(void)
 {
-  if (mem_calls || mem_bytes) {
+  const u32_t calls = zz_atomic_get(&mem_calls);
+  const u32_t bytes = zz_atomic_get(&mem_bytes);
+
+  if (calls || bytes) {
     wmsg("!!! (mem) check failed -- calls:%lu bytes:%lu\n",
-         LU(mem_calls), LU(mem_bytes));
+         LU(calls), LU(bytes));
     return E_ERR;
   }
   return E_OK;
@@ -136,8 +144,8 @@ static void * zz_libc_new(u32_t n)
     return 0;
   }
 
-  mem_calls++;                          /* GB: $$$ should be atomic */
-  mem_bytes += n;                       /* GB: $$$ should be atomic */
+  zz_atomic_add(&mem_calls, 1);
+  zz_atomic_add(&mem_bytes, n);
 
   memchk->me = &memchk->me;
   zz_memcpy(memchk->fcc,   mem_fcc, 4);
@@ -146,7 +154,8 @@ static void * zz_libc_new(u32_t n)
   zz_memset(memchk->buf, 0x55, memchk->len);
 
   dmsg("new:%p +%lu (%lu/%lu)\n",
-       memchk->buf, LU(n), LU(mem_calls),LU(mem_bytes));
+       memchk->buf, LU(n),
+       LU(zz_atomic_get(&mem_calls)), LU(zz_atomic_get(&mem_bytes)));
   return memchk->buf;
 }
 
@@ -158,15 +167,15 @@ static void zz_libc_del(void * p)
   if ( likely ( E_OK == zz_memchk_block(p)) ) {
     memchk_t * const memchk = memchk_of(p);
     u32_t const n = memchk->len;
-    mem_calls--;                          /* GB: $$$ should be atomic */
-    zz_assert( mem_calls >= 0 );
-    mem_bytes -= memchk->len;             /* GB: $$$ should be atomic */
-    zz_assert( mem_bytes < (u32_t)(mem_bytes + memchk->len) );
-    zz_assert( (!mem_calls && !mem_bytes) || (mem_calls>0 && mem_bytes>0) );
+    const u32_t calls = zz_atomic_add(&mem_calls, -1);
+    const u32_t bytes = zz_atomic_add(&mem_bytes, -n);
+    zz_assert( calls != (u32_t) -1 );
+    zz_assert( bytes < (u32_t)(bytes + n) );
     zz_memset(memchk, 0x5A, XTRA + memchk->len + 4);
     free(memchk);
     dmsg("del:%p -%lu (%lu/%lu)\n",
-         p, LU(n), LU(mem_calls), LU(mem_bytes));
+         p, LU(n),
+         LU(zz_atomic_get(&mem_calls)), LU(zz_atomic_get(&mem_bytes)));
   }
 }
 
@@ -205,6 +214,191 @@ static void mem_free(void * mem)
     delf(mem);
 }
 
+/* **********************************************************************
+   Player memory arena
+*/
+
+/* GB: Blocks are taken from the top of the current chunk. Freeing the
+ *     topmost block gives its room back (scratch buffers are usually
+ *     freed in reverse order). Other blocks are recovered when the
+ *     arena is empty. A new chunk is at least as large as all the
+ *     previous ones together. An empty arena is shrunk to a single
+ *     chunk big enough for the high-water mark so that a reused
+ *     player needs a single allocation.
+ */
+
+#define ARENA_ALIGN 16u			/* as malloc() */
+#define ARENA_MIN   0x4000u		/* default chunk size */
+#define ARENA_ROUND(N) ( ( (N) + ARENA_ALIGN-1u ) & ~(ARENA_ALIGN-1u) )
+
+typedef struct chunk_s chunk_t;
+struct chunk_s {
+  chunk_t * prev;			/* previous chunk */
+  u32_t	    max;			/* room size      */
+  u32_t	    top;			/* room used      */
+};
+
+struct arena_s {
+  chunk_t * cur;			/* current chunk    */
+  u32_t	    live;			/* allocated blocks */
+  u32_t	    size;			/* next chunk size  */
+};
+
+#define CHUNK_HEAD ARENA_ROUND(sizeof(chunk_t))
+#define BLOCK_HEAD ARENA_ROUND(sizeof(u32_t))
+
+static ZZ_TLS arena_t * arena_cur;
+
+static inline uint8_t * chunk_room(const chunk_t * C)
+{
+  return (uint8_t *) C + CHUNK_HEAD;
+}
+
+static chunk_t * chunk_new(arena_t * A, u32_t size)
+{
+  chunk_t * const C = mem_alloc(CHUNK_HEAD + size);
+
+  if (likely(C)) {
+    C->prev = A->cur;
+    C->max  = size;
+    C->top  = 0;
+    A->cur  = C;
+    dmsg("arena <%p> chunk:%p +%lu\n", (void *)A, (void *)C, LU(size));
+  }
+  return C;
+}
+
+static u32_t arena_room(const arena_t * A)
+{
+  const chunk_t * C;
+  u32_t n = 0;
+
+  for (C = A->cur; C; C = C->prev)
+    n += C->max;
+  return n;
+}
+
+static void arena_drop(arena_t * A)
+{
+  while (A->cur) {
+    chunk_t * const C = A->cur;
+    A->cur = C->prev;
+    mem_free(C);
+  }
+}
+
+/* Chunk owning a pointer (0:not in this arena). */
+static chunk_t * arena_chunk(const arena_t * A, const void * p)
+{
+  chunk_t * C;
+
+  for (C = A->cur; C; C = C->prev)
+    if ( (intptr_t) p >= (intptr_t) chunk_room(C) &&
+         (intptr_t) p <  (intptr_t) chunk_room(C) + C->max )
+      break;
+  return C;
+}
+
+static void * arena_alloc(arena_t * A, u32_t size)
+{
+  const u32_t need = BLOCK_HEAD + ARENA_ROUND(size);
+  chunk_t * C = A->cur;
+  uint8_t * blk;
+
+  if (unlikely(need < size))
+    return 0;
+  if (!C || C->max - C->top < need) {
+    u32_t max = arena_room(A);
+    if (max < A->size) max = A->size;
+    if (max < need) max = need;
+    if ( ! (C = chunk_new(A, max)) )
+      return 0;
+  }
+  blk = chunk_room(C) + C->top;
+  *(u32_t *) blk = need;
+  C->top += need;
+  ++A->live;
+  return blk + BLOCK_HEAD;
+}
+
+static void arena_free(arena_t * A, chunk_t * C, void * p)
+{
+  uint8_t * const blk = (uint8_t *) p - BLOCK_HEAD;
+  const u32_t need = *(u32_t *) blk;
+
+  zz_assert( A->live );
+  zz_assert( blk + need <= chunk_room(C) + C->top );
+  if (blk + need == chunk_room(C) + C->top)
+    C->top -= need;
+  if (!--A->live)
+    arena_reset(A);
+}
+
+zz_err_t arena_new(arena_t ** pA, zz_u32_t size)
+{
+  arena_t * A;
+
+  zz_assert( pA );
+  zz_assert( ! *pA );
+  if ( ! (A = mem_alloc(sizeof(*A))) )
+    return E_MEM;
+  A->cur  = 0;
+  A->live = 0;
+  A->size = size ? size : ARENA_MIN;
+  *pA = A;
+  return E_OK;
+}
+
+void arena_del(arena_t ** pA)
+{
+  arena_t * const A = *pA;
+
+  if (A) {
+    zz_assert( A != arena_cur );
+    zz_assert( ! A->live );
+    *pA = 0;
+    arena_drop(A);
+    mem_free(A);
+  }
+}
+
+void arena_reserve(arena_t * A, zz_u32_t size)
+{
+  if (!A || (A->cur && A->cur->max - A->cur->top >= size))
+    return;
+  size += ARENA_MIN;			/* room for the small ones */
+  if (!A->live) {
+    /* Nothing to keep: the next chunk is made big enough. */
+    arena_drop(A);
+    if (A->size < size)
+      A->size = size;
+  } else
+    chunk_new(A, size);
+}
+
+void arena_reset(arena_t * A)
+{
+  if (!A)
+    return;
+  if (A->live)
+    dmsg("arena <%p> reset with %lu blocks\n", (void *)A, LU(A->live));
+  A->live = 0;
+  if (A->cur && A->cur->prev) {
+    const u32_t size = arena_room(A);
+    arena_drop(A);
+    if (A->size < size)
+      A->size = size;
+  } else if (A->cur)
+    A->cur->top = 0;
+}
+
+arena_t * arena_use(arena_t * A)
+{
+  arena_t * const old = arena_cur;
+  arena_cur = A;
+  return old;
+}
+
 /* **********************************************************************
 */
 
@@ -219,6 +413,8 @@ zz_err_t zz_memnew(void * restrict pmem, zz_u32_t size, zz_u8_t clear)
   if (likely(pmem)) {
     void * mem = unlikely(!size)
       ? 0
+      : arena_cur
+      ? arena_alloc(arena_cur, size)
       : mem_alloc(size)
       ;
     zz_assert( ! *(void**)pmem );       /*  GB: a tad conservative */
@@ -239,8 +435,13 @@ void zz_memdel(void * restrict pmem)
   if (likely(pmem)) {
     void * const mem = *(void **)pmem;
     if (likely(mem)) {
+      arena_t * const A = arena_cur;
+      chunk_t * C;
       *(void**)pmem = 0;
-      mem_free(mem);
+      if (A && (C = arena_chunk(A, mem)))
+        arena_free(A, C, mem);
+      else
+        mem_free(mem);
     }
   }
 }
@@ -13,6 +13,8 @@
 /* ---------------------------------------------------------------------- */
 
 ZZ_EXTERN_C mixer_t mixer_zz_none, mixer_zz_lerp, mixer_zz_qerp;
+ZZ_EXTERN_C mixer_t mixer_zz_mip, mixer_zz_fir, mixer_zz_nat,
+  mixer_zz_hyb;
 
 #if WITH_SOXR == 1
 ZZ_EXTERN_C mixer_t mixer_soxr;
@@ -33,7 +35,8 @@ ZZ_EXTERN_C mixer_t mixer_test;
 #endif
 
 static mixer_t * const zz_mixers[] = {
-  &mixer_zz_qerp, &mixer_zz_lerp, &mixer_zz_none,
+  &mixer_zz_qerp, &mixer_zz_lerp, &mixer_zz_none, &mixer_zz_mip,
+  &mixer_zz_fir, &mixer_zz_nat, &mixer_zz_hyb,
 
 #if WITH_SOXR == 1
   &mixer_soxr,
@@ -11,10 +11,9 @@
 
 /* ---------------------------------------------------------------------- */
 
-zz_err_t zz_tick(play_t * restrict P)
+static inline void always_inline
+tick_ms(play_t * restrict P)
 {
-  zz_err_t ecode;
-
   P->ms_pos  = P->ms_end;
   P->ms_end += P->ms_per_tick;
   P->ms_err += P->ms_err_tick;
@@ -22,7 +21,25 @@ zz_err_t zz_tick(play_t * restrict P)
     P->ms_err -= P->rate;
     ++ P->ms_end;
   }
+}
+
+static inline u16_t always_inline
+tick_pcm(play_t * restrict P)
+{
+  u16_t cnt   = P->pcm_per_tick;
+  P->pcm_err += P->pcm_err_tick;
+  if (P->pcm_err >= P->rate) {
+    P->pcm_err -= P->rate;
+    ++cnt;
+  }
+  return cnt;
+}
 
+zz_err_t zz_tick(play_t * restrict P)
+{
+  zz_err_t ecode;
+
+  tick_ms(P);
   ecode = zz_core_tick(&P->core);
 
   if ( ZZ_OK == ecode ) {
@@ -32,12 +49,7 @@ zz_err_t zz_tick(play_t * restrict P)
       P->done |= (P->ms_pos > P->ms_max) << 2;
 
     /* PCM this frame/tick */
-    P->pcm_cnt  = P->pcm_per_tick;
-    P->pcm_err += P->pcm_err_tick;
-    if (P->pcm_err >= P->rate) {
-      P->pcm_err -= P->rate;
-      ++P->pcm_cnt;
-    }
+    P->pcm_cnt = tick_pcm(P);
   }
 
   return ecode;
@@ -45,10 +57,60 @@ zz_err_t zz_tick(play_t * restrict P)
 
 /* ---------------------------------------------------------------------- */
 
-i16_t
-zz_play(play_t * restrict P, void * restrict pcm, const i16_t n)
+#define SPAN_MAX 0x7FFF			/* pcm_cnt must fit a i16_t */
+
+/* Is the next tick only counting down waits ? */
+static inline int always_inline
+span_quiet(const play_t * restrict P)
+{
+  const core_t * const K = &P->core;
+  const chan_t * C;
+
+  /* GB: The checkpoint and the play time limit are tested before a
+   *     tick so they must fall on a span boundary.
+   */
+  if (K->tick == P->seek.next
+      || P->pcm_cnt > SPAN_MAX - P->pcm_per_tick - 1
+      || (P->ms_max == ZZ_EOF ? P->ms_end > P->ms_len
+          : P->ms_max && P->ms_end > P->ms_max))
+    return 0;
+
+  for (C = K->chan; C < K->chan+4; ++C)
+    if ( !(0x0F & K->mute & C->msk) && (C->wait <= 1 || C->note.stp) )
+      return 0;
+  return 1;
+}
+
+/* Append the following quiet ticks to the current one. */
+static void
+span_ticks(play_t * restrict P)
+{
+  core_t * const K = &P->core;
+  chan_t * C;
+
+  while (span_quiet(P)) {
+    tick_ms(P);
+    ++ K->tick;
+    K->loop &= 0x0F;
+    for (C = K->chan; C < K->chan+4; ++C)
+      if (!(0x0F & K->mute & C->msk))
+        --C->wait;
+    P->pcm_cnt += tick_pcm(P);
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+
+/* GB: With skip the mixer advances its voices without mixing (see
+ *     zz_render_parallel()). The player state is the same as after
+ *     playing the same pcm.
+ */
+static inline i16_t always_inline
+play_pcm(play_t * restrict P, void * restrict pcm, const i16_t n,
+         const u8_t skip)
 {
   i16_t ret = 0;
+  STATS_START(&P->core,t);
 
   zz_assert( P );
   zz_assert( P->core.mixer || !pcm );
@@ -61,6 +123,8 @@ zz_play(play_t * restrict P, void * restrict pcm, const i16_t n)
     i16_t cnt;
 
     if (!P->pcm_cnt) {
+      if (P->core.tick == P->seek.next)
+        seek_mark(P);
       P->core.code = zz_tick(P);
       if (P->core.code != E_OK) {
         ret = -P->core.code;
@@ -68,6 +132,12 @@ zz_play(play_t * restrict P, void * restrict pcm, const i16_t n)
       }
       if (P->done)
         break;
+      if (P->core.opts & ZZ_OPT_SPAN)
+        span_ticks(P);
+#ifndef NO_STATS
+      if (STATS_ON(&P->core) && P->pcm_cnt > P->core.stats.pcm_max)
+        P->core.stats.pcm_max = P->pcm_cnt;
+#endif
     }
 
     if (n == 0) {
@@ -90,7 +160,12 @@ zz_play(play_t * restrict P, void * restrict pcm, const i16_t n)
       cnt = P->pcm_cnt;
     P->pcm_cnt -= cnt;
 
-    if (pcm) {
+    if (skip) {
+      if (P->core.mixer->skip(&P->core, cnt) != cnt) {
+        ret = -(P->core.code = E_MIX);
+        break;
+      }
+    } else if (pcm) {
       i16_t written = P->core.mixer->push(&P->core, pcm, cnt);
       if (written < 0) {
         ret = -(P->core.code = E_MIX);
@@ -106,8 +181,7 @@ zz_play(play_t * restrict P, void * restrict pcm, const i16_t n)
       zz_assert( cnt == written );
       cnt = written;
 
-      /* $$$ GB: currently assuming all mixers returns 2x16bit pcm */
-      pcm = (int32_t *) pcm + cnt;
+      pcm = (uint8_t *) pcm + cnt * ZZ_PCM_SIZE(P->core.pcmfmt);
     }
     ret += cnt;
 
@@ -118,9 +192,25 @@ zz_play(play_t * restrict P, void * restrict pcm, const i16_t n)
     zz_assert( ret <= (n<0?-n:n) );
   } while ( ret < n );
 
+  STATS_STAGE(&P->core,play,t,ret > 0 ? ret : 0);
   return ret;
 }
 
+i16_t
+zz_play(play_t * restrict P, void * restrict pcm, const i16_t n)
+{
+  return play_pcm(P, pcm, n, 0);
+}
+
+i16_t
+play_skip(play_t * restrict P, const i16_t n)
+{
+  zz_assert( P->core.mixer );
+  zz_assert( P->core.mixer->skip );
+  zz_assert( n > 0 );
+  return play_pcm(P, 0, n, 1);
+}
+
 /* ---------------------------------------------------------------------- */
 
 zz_err_t
@@ -144,6 +234,7 @@ zz_init(play_t * P, u16_t rate, u32_t ms)
        HU(P->rate), HU(P->ms_per_tick), HU(P->ms_err_tick));
   P->pcm_per_tick = 1;
   P->pcm_err_tick = 0;
+  seek_free(P);
 
   return P->core.code = ZZ_OK;
 }
@@ -166,6 +257,12 @@ zz_setup(play_t * P, u8_t mid, u32_t spr)
   if (!P->core.vset.iref)
     goto error;
 
+  /* GB: Mixers derive per instrument data from the voice set (up to
+   *     about 6 times its size for int:fir with its scratch).
+   */
+  if (P->core.arena && P->core.vset.bin)
+    arena_reserve(P->core.arena, mulu32(P->core.vset.bin->len, 6));
+
   ecode = zz_core_init(&P->core, zz_mixer_get(&mid), spr);
   if (ecode)
     goto error;
@@ -174,6 +271,7 @@ zz_setup(play_t * P, u8_t mid, u32_t spr)
   xdivu(P->core.spr, P->rate, &P->pcm_per_tick, &P->pcm_err_tick);
   dmsg("spr=%luhz pcm:%hu(+%hu)\n",
        LU(P->core.spr), HU(P->pcm_per_tick), HU(P->pcm_err_tick));
+  seek_init(P);
 
 error:
   P->done = -!!ecode;
@@ -187,6 +285,28 @@ zz_u32_t zz_position(const zz_play_t P)
   return !P ? ZZ_EOF : P->ms_pos;
 }
 
+zz_err_t zz_stats(zz_play_t P, zz_stats_t * pstats)
+{
+  if (!P)
+    return E_ARG;
+#ifndef NO_STATS
+  if (pstats) {
+    const mixer_t * const M = P->core.mixer;
+    int i;
+
+    *pstats = P->core.stats;
+    for (i=0; M && M->stats && i<ZZ_STATS_MIX && M->stats[i]; ++i)
+      pstats->mix[i].name = M->stats[i];
+  } else
+    zz_memclr(&P->core.stats, sizeof(P->core.stats));
+  return E_OK;
+#else
+  if (pstats)
+    zz_memclr(pstats, sizeof(*pstats));
+  return E_ERR;
+#endif
+}
+
 static void memb_free(struct memb_s * memb)
 {
   if (memb && memb->bin)
@@ -208,7 +328,8 @@ static void song_wipe(song_t * song)
 
 static void vset_wipe(vset_t * vset)
 {
-  memb_wipe((struct memb_s *)vset, sizeof(*vset));
+  vset_release(vset);
+  zz_memclr(vset, sizeof(*vset));
 }
 
 static void info_wipe(info_t * info)
@@ -228,17 +349,27 @@ zz_err_t zz_close(zz_play_t P)
   zz_err_t ecode = E_ARG;
 
   if (P) {
+    arena_t * const old = arena_use(P->core.arena);
+
     zz_core_kill(&P->core);
+    seek_free(P);
 
     zz_wipe(P);
     zz_strdel(&P->songuri);
     zz_strdel(&P->vseturi);
     zz_strdel(&P->infouri);
+    arena_use(old);
+    arena_reset(P->core.arena);
     P->st_idx = 0;
     P->pcm_per_tick = 0;
     P->format = ZZ_FORMAT_UNKNOWN;
     P->rate = 0;
 
+    /* Rewind the play clock so that the player can be reused. */
+    P->ms_pos = P->ms_end = P->ms_err = 0;
+    P->pcm_cnt = P->pcm_err = 0;
+    P->done = 0;
+
     ecode = E_OK;
   }
   return ecode;
@@ -249,6 +380,7 @@ void zz_del(zz_play_t * pP)
   zz_assert( pP );
   if (pP && *pP) {
     zz_close(*pP);
+    arena_del(&(*pP)->core.arena);
     zz_free(pP);
   }
 }
@@ -259,6 +391,16 @@ zz_err_t zz_new(zz_play_t * pP)
   return zz_calloc(pP,sizeof(**pP));
 }
 
+zz_err_t zz_arena(zz_play_t P, zz_u32_t size)
+{
+  if (!P)
+    return E_ARG;
+  if (P->songuri || P->core.mixer)
+    return E_PLA;			/* not closed */
+  arena_del(&P->core.arena);
+  return arena_new(&P->core.arena, size);
+}
+
 static char empty_str[] = "";
 #define NEVER_NIL(S) if ( (S) ) {} else (S) = empty_str
 
@@ -275,9 +417,6 @@ const char * zz_formatstr(zz_u8_t fmt)
   return "?";
 }
 
-extern zz_u8_t  zz_chan_map;
-extern zz_u16_t zz_chan_lr8;
-
 zz_err_t zz_info(zz_play_t P, zz_info_t * pinfo)
 {
   zz_assert(pinfo);
@@ -285,9 +424,10 @@ zz_err_t zz_info(zz_play_t P, zz_info_t * pinfo)
     return E_ARG;
 
   if (!P || P->format == ZZ_FORMAT_UNKNOWN) {
+    const zz_u32_t blend = zz_core_blend(0, -1, -1);
     zz_memclr(pinfo,sizeof(*pinfo));
-    pinfo->mix.map  = zz_chan_map;
-    pinfo->mix.lr8  = zz_chan_lr8;
+    pinfo->mix.map  = blend & 0xFFFFu;
+    pinfo->mix.lr8  = blend >> 16;
     pinfo->mix.spr  = SPR_DEF;
     pinfo->len.rate = RATE_DEF;
     pinfo->fmt.str  = zz_formatstr(pinfo->fmt.num);
@@ -304,10 +444,15 @@ zz_err_t zz_info(zz_play_t P, zz_info_t * pinfo)
       P->rate ? P->rate : P->core.song.rate;
     pinfo->mix.spr  = P->core.spr;
     pinfo->len.ms   = P->ms_len;
+    pinfo->len.loop = divu32( mulu32(P->core.song.lpos,1000), P->rate );
+    pinfo->len.llen = !P->core.song.llen ? 0 :
+      divu32( mulu32(P->core.song.lpos+P->core.song.llen,1000), P->rate )
+      - pinfo->len.loop;
 
     /* Blending */
     pinfo->mix.map  = P->core.cmap;
-    pinfo->mix.lr8  = P->core.cmap;
+    pinfo->mix.lr8  = P->core.lr8;
+    pinfo->mix.pcm  = P->core.pcmfmt;
 
     /* mixer */
     pinfo->mix.num = P->mixer_id;
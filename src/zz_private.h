@@ -22,6 +22,7 @@
 # define NO_FLOAT
 # define NO_LIBC
 # define NO_VFS
+# define NO_STATS
 # ifdef SC68
 #  define NO_LOG
 # endif
@@ -164,6 +165,7 @@ typedef struct bin_s   bin_t;	  /**< binary data container.     */
 typedef struct q4_s    q4_t;	  /**< 4q header.                 */
 typedef struct info_s  info_t;	  /**< song info.                 */
 typedef struct vset_s  vset_t;	  /**< voice set (.set file).     */
+typedef struct vcache_s vcache_t; /**< shared voice set.          */
 typedef struct inst_s  inst_t;	  /**< instrument.                */
 typedef struct song_s  song_t;	  /**< song (.4v file).           */
 typedef struct sequ_s  sequ_t;	  /**< sequence definition.       */
@@ -172,6 +174,9 @@ typedef struct play_s  play_t;	  /**< high level player.         */
 typedef struct chan_s  chan_t;	  /**< one channel.               */
 typedef struct note_s  note_t;	  /**< channel step (pitch) info. */
 typedef struct mixer_s mixer_t;	  /**< channel mixer.             */
+typedef struct arena_s arena_t;	  /**< player memory arena.       */
+typedef struct ncache_s ncache_t; /**< rendered note cache.       */
+typedef struct nce_s   nce_t;	  /**< rendered note.             */
 typedef struct songhd songhd_t;	  /**< .4v file header.           */
 
 typedef struct vfs_s * vfs_t;
@@ -205,6 +210,7 @@ struct bin_s {
   uint8_t *ptr;			     /**< pointer to data (_buf).   */
   u32_t	   max;			     /**< maximum allocated string. */
   u32_t	   len;			     /**< length including.         */
+  zz_vfs_dri_t dri;		     /**< mapped by (0:allocated).  */
   uint8_t _buf[1];		     /**< buffer (always last).     */
 };
 
@@ -230,6 +236,7 @@ struct vset_s {
   uint8_t one;		     /**< value of positive max PCM.        */
   u32_t	 unroll;	     /**< unrolled amount.                  */
   u32_t	 iref;		     /**< mask of instrument referenced.    */
+  vcache_t *vce;	     /**< cache entry (0: private).         */
   inst_t inst[20];	     /**< instrument definitions.           */
 };
 
@@ -247,7 +254,9 @@ struct song_s {
   u32_t	  iref;		     /**< mask of instrument referened.     */
   u32_t	  stepmin;	     /**< estimated minimal note been used. */
   u32_t	  stepmax;	     /**< estimated maximal note been used. */
-  u32_t	  ticks;	     /**< estimated song length in ticks.   */
+  u32_t	  ticks;	     /**< song length in ticks.             */
+  u32_t	  lpos;		     /**< loop point (in ticks).            */
+  u32_t	  llen;		     /**< loop length (in ticks, 0:n/a).    */
   sequ_t *seq[4];	     /**< pointers to channel sequences.    */
   uint8_t istep[20];	     /**< max step per instrument.          */
 };
@@ -317,6 +326,7 @@ struct core_s {
   void	  *user;		/**< User data. */
   mixer_t *mixer;		/**< Mixer to use. */
   void	  *data;		/**< Mixer private data. */
+  arena_t *arena;		/**< Memory arena (0:heap). */
   u32_t	   tick;		/**< current tick (0:init 1:first). */
   u32_t	   spr;			/**< Sampling rate (hz). */
   u16_t	   lr8;			/**< L/R channels blending. */
@@ -324,8 +334,25 @@ struct core_s {
   uint8_t  loop;		/**< #0-3:loop #4-7:tick loop. */
   uint8_t  code;		/**< Error code. */
   uint8_t  cmap;		/**< channel mapping (ZZ_MAP_*). */
+  uint8_t  opts;		/**< core options (ZZ_OPT_*). */
+  uint8_t  pcmfmt;		/**< output pcm format (ZZ_PCM_*). */
 
   chan_t   chan[4];		/**< 4 channels info. */
+#ifndef NO_STATS
+  zz_stats_t stats;		/**< performance statistics. */
+#endif
+};
+
+/**
+ * Seek checkpoints (zz_seek.c).
+ */
+struct seek_s {
+  uint8_t *buf;			/**< checkpoint records.           */
+  u32_t	   len;			/**< size of one record.           */
+  u32_t	   every;		/**< ticks between 2 checkpoints.  */
+  u32_t	   next;		/**< next tick to save (or ZZ_EOF) */
+  u16_t	   cnt;			/**< number of saved records.      */
+  u16_t	   max;			/**< number of allocated records.  */
 };
 
 struct play_s {
@@ -359,6 +386,8 @@ struct play_s {
   uint8_t done;		   /**< non zero when done.  */
   uint8_t format;	   /**< see ZZ_FORMAT_ enum. */
   uint8_t mixer_id;	   /**< mixer identifier.    */
+
+  struct seek_s seek;	   /**< seek checkpoints.    */
 };
 
 /* ---------------------------------------------------------------------- */
@@ -473,6 +502,145 @@ static inline void always_inline poke_b32(uint8_t * const a, u32_t v)
  * @}
  */
 
+/**
+ * Thread safety (process wide library state).
+ * @{
+ */
+#if defined __GNUC__ && !defined __m68k__ && !defined NO_LIBC
+# define ZZ_TLS __thread
+# define zz_atomic_get(P)     __atomic_load_n((P), __ATOMIC_ACQUIRE)
+# define zz_atomic_set(P,V)   __atomic_store_n((P), (V), __ATOMIC_RELEASE)
+# define zz_atomic_add(P,V)   __atomic_add_fetch((P), (V), __ATOMIC_ACQ_REL)
+# define zz_atomic_cas(P,O,N) __atomic_compare_exchange_n(	\
+    (P), (O), (N), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#else
+/* GB: Single threaded targets. */
+# define ZZ_TLS
+# define zz_atomic_get(P)     (*(P))
+# define zz_atomic_set(P,V)   (*(P) = (V))
+# define zz_atomic_add(P,V)   (*(P) += (V))
+# define zz_atomic_cas(P,O,N)					\
+  ( *(P) == *(O) ? (*(P) = (N), 1) : (*(O) = *(P), 0) )
+#endif
+/**
+ * @}
+ */
+
+/**
+ * Performance statistics (ZZ_OPT_STATS).
+ *
+ * STATS_START() declares a time stamp that STATS_STAGE() charges to
+ * a stage before restarting it. STATS_ADD() adds to a counter and
+ * STATS_MIX() to a mixer specific one. They are no-ops unless the
+ * option is set and vanish with NO_STATS.
+ * @{
+ */
+#if !defined NO_STATS && defined NO_LIBC
+# define NO_STATS
+#endif
+
+#ifndef NO_STATS
+# include <time.h>
+
+static inline u64_t
+stats_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (u64_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+/* Number of notes triggered by the next mixer push. */
+static inline u8_t
+stats_notes(const core_t * const K)
+{
+  return (K->chan[0].trig == TRIG_NOTE) + (K->chan[1].trig == TRIG_NOTE)
+    + (K->chan[2].trig == TRIG_NOTE) + (K->chan[3].trig == TRIG_NOTE);
+}
+
+# define STATS_ON(K) unlikely( (K)->opts & ZZ_OPT_STATS )
+# define STATS_START(K,T) u64_t T = STATS_ON(K) ? stats_ns() : 0
+# define STATS_STAGE(K,S,T,N) do {                     \
+    if (STATS_ON(K)) {                                  \
+      const u64_t _t = stats_ns();                      \
+      (K)->stats.S.ns  += _t - (T);                     \
+      (K)->stats.S.cnt += (N);                          \
+      (T) = _t;                                         \
+    }                                                   \
+  } while (0)
+# define STATS_ADD(K,F,N) do {                         \
+    if (STATS_ON(K))                                    \
+      (K)->stats.F += (N);                              \
+  } while (0)
+# define STATS_MIX(K,I,N) STATS_ADD(K,mix[I].cnt,N)
+#else
+# define STATS_ON(K) 0
+# define STATS_START(K,T)
+# define STATS_STAGE(K,S,T,N) do {} while (0)
+# define STATS_ADD(K,F,N) do {} while (0)
+# define STATS_MIX(K,I,N) do {} while (0)
+#endif
+
+/**
+ * Count the output samples at full scale (mix_help.c).
+ */
+ZZ_EXTERN_C
+u32_t mix_clips(const void * pcm, u8_t fmt, int n);
+/**
+ * @}
+ */
+
+/**
+ * Rendered note cache (mix_cache.c).
+ *
+ * Notes are addressed by instrument and resampling step. A voice
+ * holds a reference on its note while it reads (or writes) its pcm
+ * from the start.
+ * @{
+ */
+#ifndef NCACHE_SIZE
+# define NCACHE_SIZE (1<<20)		/* memory budget (bytes) */
+#endif
+
+ZZ_EXTERN_C
+zz_err_t ncache_new(ncache_t ** pnc, u32_t size);
+ZZ_EXTERN_C
+void ncache_del(ncache_t ** pnc);
+/** Get a referenced note (0:none), hit is set if it already exists. */
+ZZ_EXTERN_C
+nce_t * ncache_get(ncache_t * nc, u32_t ins, u32_t xtp, u8_t * hit);
+/** Release the reference on a note. */
+ZZ_EXTERN_C
+void ncache_put(ncache_t * nc, nce_t ** pE);
+/** Copy up to n pcm stored at pos, returns the number copied. */
+ZZ_EXTERN_C
+int ncache_read(const ncache_t * nc, const nce_t * E,
+                u32_t pos, int16_t * d, int n);
+/** Store up to n pcm at pos (the end), returns the number stored. */
+ZZ_EXTERN_C
+int ncache_write(ncache_t * nc, nce_t * E,
+                 u32_t pos, const int16_t * s, int n);
+/**
+ * @}
+ */
+
+/**
+ * Advance a note portamento by n ticks. Same as n consecutive
+ * sequencer ticks without any event.
+ */
+static inline void
+note_slide(note_t * const note, const u32_t n)
+{
+  const int64_t cur = note->cur ? note->cur : note->aim;
+  const int64_t end = cur + (int64_t) note->stp * n;
+
+  note->cur = end;
+  if (note->stp > 0 ? end >= note->aim : end <= note->aim) {
+    note->cur = note->aim;
+    note->stp = 0;
+  }
+}
+
 /* ---------------------------------------------------------------------- */
 
 /**
@@ -481,12 +649,25 @@ static inline void always_inline poke_b32(uint8_t * const a, u32_t v)
  */
 ZZ_EXTERN_C
 void map_i16_to_i16(int16_t * d,
-		    const i16_t * va, const i16_t * vb,
-		    const i16_t * vc, const i16_t * vd,
+		    const int16_t * va, const int16_t * vb,
+		    const int16_t * vc, const int16_t * vd,
 		    const i16_t sc1, const i16_t sc2, int n);
 
+/** Map to pcm format fmt. Returns d past the last pcm. */
+ZZ_EXTERN_C
+void * map_i16_to_pcm(void * d, u8_t fmt,
+		      const int16_t * va, const int16_t * vb,
+		      const int16_t * vc, const int16_t * vd,
+		      const i16_t sc1, const i16_t sc2, int n);
+
 #ifndef NO_FLOAT
 
+ZZ_EXTERN_C
+void * map_flt_to_pcm(void * d, u8_t fmt,
+		      const float * va, const float * vb,
+		      const float * vc, const float * vd,
+		      const float sc1, const float sc2, const int n);
+
 ZZ_EXTERN_C
 void map_flt_to_i16(int16_t * d,
 		    const float * va, const float * vb,
@@ -500,6 +681,148 @@ ZZ_EXTERN_C
 void fltoi16(int16_t * const d, const float * const s, const int n);
 
 #endif /* NO_FLOAT */
+
+#define MIX_BANDS 6	/**< max band-limited levels (1/32 band). */
+
+/**
+ * Low-pass x to y one octave below a previous level low-passed with
+ * a dilation of d/2 (use d=1 for the first one). Loops are periodic
+ * both ways. Samples are 16-bit in 32-bit.
+ */
+ZZ_EXTERN_C
+void mix_halfband(int32_t * y, const int32_t * x,
+		  const i32_t d, const i32_t len, const i32_t lpl);
+
+/** Number of band-limited levels (up to MIX_BANDS) for a step. */
+ZZ_EXTERN_C
+u8_t mix_bands(const u32_t xtp);
+
+/**
+ * Band-limited 16-bit levels of the instruments (int:fir). Each level
+ * is padded with FIR_PREV pcm of silence before and FIR_NEXT pcm of
+ * loop (or silence) after.
+ */
+typedef struct fir_s fir_t;
+struct fir_s {
+  int16_t * buf;			/**< levels storage.        */
+  int16_t * lvl[20][MIX_BANDS];		/**< level pcm per inst.    */
+  u32_t	    end[20];			/**< level end (pcm).       */
+  uint8_t   nlv[20];			/**< number of levels (0:n/a). */
+};
+
+/** Build the fir->nlv[] levels of every instrument of vset. */
+ZZ_EXTERN_C
+zz_err_t mix_fir_levels(fir_t * fir, const vset_t * vset);
+
+/** Voice set preparation for lerp (1 additional pcm). */
+ZZ_EXTERN_C
+zz_err_t mix_prep_lerp(vset_t * vset);
+
+#define FIR_TAPS   32			/**< int:fir kernel taps. */
+#define FIR_PHASE  7			/**< int:fir log2(phases). */
+#define FIR_PHASES (1<<FIR_PHASE)	/**< int:fir phases. */
+
+#define FIR_HALF   (FIR_TAPS/2)
+#define FIR_PREV   (FIR_HALF-1)		/**< int:fir taps before the pcm. */
+#define FIR_RND    (1 << (FP-FIR_PHASE-1)) /**< int:fir nearest phase. */
+#define FIR_ONE    14			/**< int:fir coefficients scale. */
+#define FIR_NEXT   (FIR_TAPS+1)		/**< int:fir pcm after the end. */
+
+/** int:fir polyphase table (Q14, see mix_fir.py). */
+ZZ_EXTERN_C
+const int16_t fir_coef[FIR_PHASES][FIR_TAPS];
+
+/** int:fir kernel at index idx (fixed-point FP) of pcm. */
+static inline i16_t
+fir_pcm(const int16_t * const pcm, u32_t idx)
+{
+  const u32_t p = ( idx + FIR_RND ) >> ( FP - FIR_PHASE );
+  const int16_t * const x = pcm + ( p >> FIR_PHASE ) - FIR_PREV;
+  const int16_t * const h = fir_coef[p & (FIR_PHASES-1)];
+  i32_t r = 1 << (FIR_ONE-1);
+  int t;
+
+  for (t=0; t<FIR_TAPS; ++t)
+    r += h[t] * x[t];
+  r >>= FIR_ONE;
+  return r < -0x8000 ? -0x8000 : r > 0x7FFF ? 0x7FFF : r;
+}
+
+/**
+ * Vector kernels (runtime dispatch). They process the head of a run
+ * and return the number of pcm done (possibly 0). The caller does
+ * the rest with its scalar code.
+ */
+ZZ_EXTERN_C
+int simd_lerp(int16_t * d, const uint8_t * pcm, u32_t idx, u32_t stp,
+	      int n, u32_t lim);
+
+ZZ_EXTERN_C
+int simd_qerp(int16_t * d, const uint8_t * pcm, u32_t idx, u32_t stp,
+	      int n, u32_t lim);
+
+ZZ_EXTERN_C
+int simd_fir(int16_t * d, const int16_t * pcm, u32_t idx, u32_t stp,
+	     int n, u32_t lim);
+
+ZZ_EXTERN_C
+int simd_map_i16(int16_t * d,
+		 const int16_t * va, const int16_t * vb,
+		 const int16_t * vc, const int16_t * vd,
+		 int sc1, int sc2, int n);
+
+#ifndef NO_FLOAT
+ZZ_EXTERN_C
+int simd_map_flt(int16_t * d,
+		 const float * va, const float * vb,
+		 const float * vc, const float * vd,
+		 float sc1, float sc2, int n);
+#endif
+
+/**
+ * One voice of the fused resample and mix kernels. Stopped voices
+ * read a silent pcm with a null step.
+ */
+typedef struct mix_fuse_s mix_fuse_t;
+struct mix_fuse_s {
+  const uint8_t * pcm;			/**< instrument pcm.       */
+  u32_t idx;				/**< index (updated).      */
+  u32_t stp;				/**< step.                 */
+  u32_t lim;				/**< pcm readable.         */
+};
+
+/**
+ * Fused kernels resample the 4 voices and mix them to 16-bit stereo
+ * in one pass (as simd_lerp() or simd_qerp() then simd_map_i16()).
+ * They return -1 if the CPU only has the separate kernels.
+ */
+ZZ_EXTERN_C
+int simd_fuse_lerp(int16_t * d, mix_fuse_t * v, int lr8, int n);
+
+ZZ_EXTERN_C
+int simd_fuse_qerp(int16_t * d, mix_fuse_t * v, int lr8, int n);
+
+#ifndef NO_THREAD
+
+typedef struct mix_pool_s mix_pool_t;
+
+/** Render n pcm of voice k (0..3). Returns 0 on success. */
+typedef int (*mix_job_t)(void * user, int k, int n);
+
+/** Create voice worker threads (voice 3 runs on the caller). */
+ZZ_EXTERN_C
+zz_err_t mix_pool_new(mix_pool_t ** ppool, mix_job_t job, void * user);
+
+/** Stop and delete voice worker threads. */
+ZZ_EXTERN_C
+void mix_pool_del(mix_pool_t ** ppool);
+
+/** Run the job for the 4 voices. Returns the ORed job results. */
+ZZ_EXTERN_C
+int mix_pool_run(mix_pool_t * pool, int n);
+
+#endif /* NO_THREAD */
+
 /**
  * @}
  */
@@ -585,6 +908,8 @@ ZZ_EXTERN_C
 zz_err_t vfs_seek(vfs_t vfs, zz_u32_t pos, zz_u8_t set);
 ZZ_EXTERN_C
 zz_err_t vfs_push(vfs_t vfs, const void * b, zz_u8_t n);
+ZZ_EXTERN_C
+void * vfs_map(vfs_t vfs, zz_u32_t n, zz_u32_t x);
 
 /**
  * @}
@@ -629,3 +954,79 @@ zz_err_t vset_unroll(zz_vset_t const vset, const uint8_t * tohw);
 /**
  * @}
  */
+
+/* ---------------------------------------------------------------------- */
+
+/**
+ * Shared voice set cache (zz_vset.c).
+ * @{
+ */
+
+/** Voice set preparation (writes the sample memory). */
+typedef zz_err_t (*vset_prep_t)(vset_t *);
+
+/** Share a freshly loaded voice set (or use an identical one). */
+ZZ_EXTERN_C
+zz_err_t vset_share(vset_t * vset);
+
+/**
+ * Apply a preparation to a voice set. Players using the same
+ * preparation (function) share the result.
+ */
+ZZ_EXTERN_C
+zz_err_t vset_prepare(vset_t * vset, vset_prep_t prep);
+
+/** Release the voice set memory (shared or not). */
+ZZ_EXTERN_C
+void vset_release(vset_t * vset);
+/**
+ * @}
+ */
+
+/* ---------------------------------------------------------------------- */
+
+/**
+ * Player memory arena (zz_mem.c).
+ *
+ * While an arena is in use by the calling thread zz_memnew() carves
+ * blocks out of it and zz_memdel() gives them back. Memory that may
+ * outlive the player (e.g. shared voice sets) must be allocated with
+ * no arena in use.
+ * @{
+ */
+ZZ_EXTERN_C
+zz_err_t arena_new(arena_t ** pA, zz_u32_t size);
+ZZ_EXTERN_C
+void arena_del(arena_t ** pA);
+/** Make room for size bytes (in a single chunk). */
+ZZ_EXTERN_C
+void arena_reserve(arena_t * A, zz_u32_t size);
+/** Release all blocks at once. */
+ZZ_EXTERN_C
+void arena_reset(arena_t * A);
+/** Set the calling thread arena (0:none), returns the previous one. */
+ZZ_EXTERN_C
+arena_t * arena_use(arena_t * A);
+/**
+ * @}
+ */
+
+/* ---------------------------------------------------------------------- */
+
+/**
+ * Seek checkpoints (zz_seek.c).
+ * @{
+ */
+ZZ_EXTERN_C
+void seek_init(play_t * P);
+ZZ_EXTERN_C
+void seek_free(play_t * P);
+ZZ_EXTERN_C
+void seek_mark(play_t * P);
+/**
+ * @}
+ */
+
+/** Play up to n pcm with the mixer skip function (no output). */
+ZZ_EXTERN_C
+i16_t play_skip(play_t * P, i16_t n);
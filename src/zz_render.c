@@ -0,0 +1,221 @@
+/**
+ * @file   zz_render.c
+ * @author Benjamin Gerard AKA Ben/OVR
+ * @date   2026-10-16
+ * @brief  Parallel offline rendering.
+ */
+
+#define ZZ_DBG_PREFIX "(ren) "
+#include "zz_private.h"
+
+#ifndef NO_THREAD
+# include <pthread.h>
+# include <unistd.h>
+#endif
+
+#define SEG_MAX ZZ_RENDER_MAX		/* max segments (threads) */
+#define SEG_PCM 0x7FFF			/* pcm per zz_play() call */
+
+/* GB: The sequencer and the mixer voices are deterministic. A first
+ *     pass plays the requested pcm with the mixer skip function
+ *     (no mixing) and records the player at the start of every
+ *     segment. The segments are then rendered by copies of these
+ *     records on their own threads. Every copy has its own mixer
+ *     (restored from the recorded state) but shares the song and
+ *     the voice set of the player, both read-only once it is set
+ *     up. The player itself ends up after the last pcm as the first
+ *     pass left it.
+ */
+typedef struct seg_s seg_t;
+struct seg_s {
+  play_t    play;			/* player at the segment start */
+  uint8_t * state;			/* mixer state at that time */
+  uint8_t * pcm;			/* segment output */
+  u32_t     n;				/* segment pcm */
+  zz_err_t  ecode;			/* segment result */
+#ifndef NO_THREAD
+  pthread_t tid;			/* segment thread */
+  int8_t    ok;				/* thread is running */
+#endif
+};
+
+/* GB: The player copy still points into the player it was copied
+ *     from. The loop stack and the instruments pointers have to
+ *     point into the copy itself. */
+static void
+seg_rebase(play_t * W, const play_t * P)
+{
+  int k;
+
+  for (k=0; k<4; ++k) {
+    const chan_t * const C = P->core.chan+k;
+    chan_t * const D = W->core.chan+k;
+
+    D->loop_sp = D->loops + (C->loop_sp - C->loops);
+    if (C->note.ins)
+      D->note.ins = W->core.vset.inst + (C->note.ins - P->core.vset.inst);
+    if (C->ins)
+      D->ins = W->core.vset.inst + (C->ins - P->core.vset.inst);
+  }
+}
+
+/* Play n pcm (or skip them), *pn receives the number played. */
+static zz_err_t
+play_run(play_t * P, uint8_t * pcm, const u32_t n, u32_t * pn,
+         const u8_t skip)
+{
+  const u8_t size = ZZ_PCM_SIZE(P->core.pcmfmt);
+  u32_t done = 0;
+
+  while (done < n) {
+    const i16_t m = n-done < SEG_PCM ? n-done : SEG_PCM;
+    const i16_t r = skip
+      ? play_skip(P, m)
+      : zz_play(P, pcm + mulu32(done, size), m);
+    if (r < 0) {
+      *pn = done;
+      return -r;
+    }
+    done += r;
+    if (r < m)
+      break;
+  }
+  *pn = done;
+  return E_OK;
+}
+
+/* Render one segment with its own mixer. */
+static void *
+seg_render(void * arg)
+{
+  seg_t * const S = arg;
+  play_t * const W = &S->play;
+  mixer_t * const M = W->core.mixer;
+  arena_t * const old = arena_use(0);
+  const u32_t spr = W->core.spr;
+  u32_t n;
+
+  W->core.spr = 0;
+  S->ecode = M->init(&W->core, spr);
+  if (!S->ecode) {
+    M->restore(&W->core, S->state);
+    S->ecode = play_run(W, S->pcm, S->n, &n, 0);
+    if (!S->ecode && n != S->n) {
+      emsg("segment played %lu pcm out of %lu\n", LU(n), LU(S->n));
+      S->ecode = E_MIX;
+    }
+  }
+  M->free(&W->core);
+  arena_use(old);
+  return 0;
+}
+
+/* Number of segments. */
+static u8_t
+seg_count(const play_t * P, u8_t threads, const u32_t n)
+{
+  const u32_t max = n / P->core.spr;	/* at least a second each */
+
+#ifdef NO_THREAD
+  threads = 1;
+#elif defined _SC_NPROCESSORS_ONLN
+  if (!threads) {
+    const long cpu = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = cpu < 1 ? 1 : cpu > SEG_MAX ? SEG_MAX : cpu;
+  }
+#endif
+  if (threads > SEG_MAX)
+    threads = SEG_MAX;
+  if (threads > max)
+    threads = max;
+  return threads ? threads : 1;
+}
+
+zz_err_t
+zz_render_parallel(play_t * P, void * pcm, u32_t * pn, u8_t threads)
+{
+  mixer_t * M;
+  seg_t * seg = 0;
+  uint8_t * state = 0;
+  arena_t * old;
+  zz_err_t ecode;
+  u32_t n, len = 0, pos = 0;
+  u8_t size, nseg, k;
+
+  if (!P || !pn || (*pn && !pcm))
+    return E_ARG;
+  n = *pn;
+  *pn = 0;
+  if (P->core.code)
+    return P->core.code;
+  if (!(M = P->core.mixer) || !P->rate)
+    return E_PLA;
+
+  size = ZZ_PCM_SIZE(P->core.pcmfmt);
+  nseg = seg_count(P, threads, n);
+  if (M->skip && M->save && M->restore)
+    len = M->save(&P->core, 0);
+  if (nseg < 2 || !len)
+    /* Nothing to share (or mixer unable to skip). */
+    return play_run(P, pcm, n, pn, 0);
+
+  old = arena_use(0);
+  if ( (ecode = zz_calloc(&seg, nseg*sizeof(*seg)))
+       || (ecode = zz_malloc(&state, mulu32(len, nseg))) )
+    goto exit;
+
+  /* First pass: record the segments start. */
+  for (k=0; k<nseg; ++k) {
+    seg_t * const S = seg+k;
+    const u32_t end = (u64_t) n * (k+1) / nseg;
+
+    S->play  = *P;
+    seg_rebase(&S->play, P);
+    S->state = state + mulu32(len, k);
+    S->pcm   = (uint8_t *) pcm + mulu32(pos, size);
+    M->save(&P->core, S->state);
+
+    /* GB: The copies never mark checkpoints nor own any memory. */
+    S->play.core.data  = 0;
+    S->play.core.arena = 0;
+    zz_memclr(&S->play.seek, sizeof(S->play.seek));
+    S->play.seek.next  = ZZ_EOF;
+
+    ecode = play_run(P, 0, end - pos, &S->n, 1);
+    pos += S->n;
+    if (ecode)
+      goto exit;
+    if (pos < end) {
+      nseg = k+1;			/* end of music */
+      break;
+    }
+  }
+  dmsg("%hu segments for %lu pcm\n", HU(nseg), LU(pos));
+
+  /* Second pass: render the segments. */
+#ifndef NO_THREAD
+  for (k=1; k<nseg; ++k)
+    seg[k].ok = !pthread_create(&seg[k].tid, 0, seg_render, seg+k);
+#endif
+  seg_render(seg);
+  for (k=1; k<nseg; ++k) {
+#ifndef NO_THREAD
+    if (seg[k].ok)
+      pthread_join(seg[k].tid, 0);
+    else
+#endif
+      seg_render(seg+k);
+  }
+  for (k=0; k<nseg && !ecode; ++k)
+    ecode = seg[k].ecode;
+  if (!ecode)
+    *pn = pos;
+
+exit:
+  zz_free(&state);
+  zz_free(&seg);
+  arena_use(old);
+  if (ecode)
+    P->core.code = ecode;
+  return ecode;
+}
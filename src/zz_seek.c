@@ -0,0 +1,337 @@
+/**
+ * @file   zz_seek.c
+ * @author Benjamin Gerard AKA Ben/OVR
+ * @date   2026-10-16
+ * @brief  Seeking with player state checkpoints.
+ */
+
+#define ZZ_DBG_PREFIX "(sek) "
+#include "zz_private.h"
+
+#ifndef SEEK_EVERY
+# define SEEK_EVERY 5			/* seconds between checkpoints */
+#endif
+
+#define SEEK_PCM 256			/* scratch buffer size (pcm) */
+
+typedef struct ckpt_s ckpt_t;
+
+/**
+ * Checkpoint record header (followed by the mixer state).
+ */
+struct ckpt_s {
+  u32_t	  tick;			/**< core tick.                   */
+  u32_t	  ms_end;		/**< tick start position (in ms). */
+  u16_t	  ms_err;		/**< ms error accumulator.        */
+  u16_t	  pcm_err;		/**< pcm error accumulator.       */
+  uint8_t loop;			/**< core loop flags.             */
+  chan_t  chan[4];		/**< channels state.              */
+};
+
+#define CKPT_HEAD ((sizeof(ckpt_t)+7u) & ~7u)
+
+static inline ckpt_t *
+ckpt_rec(play_t * P, u16_t i)
+{
+  return (ckpt_t *) ( P->seek.buf + mulu32(P->seek.len, i) );
+}
+
+/* ---------------------------------------------------------------------- */
+
+void
+seek_free(play_t * P)
+{
+  arena_t * const old = arena_use(P->core.arena);
+  zz_free(&P->seek.buf);
+  arena_use(old);
+  zz_memclr(&P->seek, sizeof(P->seek));
+  P->seek.next = ZZ_EOF;
+}
+
+void
+seek_init(play_t * P)
+{
+  mixer_t * const M = P->core.mixer;
+
+  seek_free(P);
+  if (M && M->save && M->restore) {
+    P->seek.len   = ( CKPT_HEAD + M->save(&P->core,0) + 7u ) & ~7u;
+    P->seek.every = mulu(P->rate, SEEK_EVERY);
+    P->seek.next  = 0;
+  }
+  dmsg("checkpoints: %lu bytes every %lu ticks\n",
+       LU(P->seek.len), LU(P->seek.every));
+}
+
+void
+seek_mark(play_t * P)
+{
+  ckpt_t * rec;
+
+  if (P->core.tick != P->seek.next)
+    return;
+
+  if (P->seek.cnt == P->seek.max) {
+    arena_t * const old = arena_use(P->core.arena);
+    uint8_t * buf = 0;
+    const u16_t max = P->seek.max ? P->seek.max << 1 : 16;
+
+    if (max < P->seek.max
+        || zz_malloc(&buf, mulu32(P->seek.len, max))) {
+      arena_use(old);
+      wmsg("no more checkpoints @%lu\n", LU(P->core.tick));
+      P->seek.next = ZZ_EOF;
+      return;
+    }
+    if (P->seek.buf)
+      zz_memcpy(buf, P->seek.buf, mulu32(P->seek.len, P->seek.cnt));
+    zz_free(&P->seek.buf);
+    arena_use(old);
+    P->seek.buf = buf;
+    P->seek.max = max;
+  }
+
+  zz_assert( P->pcm_cnt == 0 );
+  rec = ckpt_rec(P, P->seek.cnt++);
+  rec->tick    = P->core.tick;
+  rec->ms_end  = P->ms_end;
+  rec->ms_err  = P->ms_err;
+  rec->pcm_err = P->pcm_err;
+  rec->loop    = P->core.loop;
+  zz_memcpy(rec->chan, P->core.chan, sizeof(rec->chan));
+  P->core.mixer->save(&P->core, (uint8_t *)rec + CKPT_HEAD);
+  P->seek.next += P->seek.every;
+}
+
+/* Closest checkpoint at or before tick (P->seek.cnt must not be 0). */
+static u16_t
+ckpt_index(const play_t * P, u32_t tick)
+{
+  u32_t i = tick / P->seek.every;
+  if (i >= P->seek.cnt)
+    i = P->seek.cnt-1;
+  return i;
+}
+
+static void
+seek_restore(play_t * P, u16_t i)
+{
+  const ckpt_t * const rec = ckpt_rec(P, i);
+
+  dmsg("restore checkpoint #%hu @%lu\n", HU(i), LU(rec->tick));
+  P->core.tick = rec->tick;
+  P->core.loop = rec->loop;
+  zz_memcpy(P->core.chan, rec->chan, sizeof(rec->chan));
+  P->core.mixer->restore(&P->core, (const uint8_t *)rec + CKPT_HEAD);
+
+  P->ms_pos  = P->ms_end = rec->ms_end;
+  P->ms_err  = rec->ms_err;
+  P->pcm_err = rec->pcm_err;
+  P->pcm_cnt = 0;
+  P->done    = 0;
+  /* GB: Replay is deterministic so later checkpoints remain valid
+   *     and recording resumes after the last one (see zz_skip()).
+   */
+  P->seek.next = mulu32(P->seek.every, P->seek.cnt);
+}
+
+/* Restart from the beginning (mixers without checkpoint support). */
+static zz_err_t
+seek_restart(play_t * P)
+{
+  core_t * const K = &P->core;
+  mixer_t * const M = K->mixer;
+  const u32_t spr = K->spr;
+  const u8_t cmap = K->cmap;
+  const u16_t lr8 = K->lr8;
+  zz_err_t ecode;
+
+  dmsg("restart from the beginning\n");
+  zz_core_kill(K);
+  ecode = zz_core_init(K, M, spr);
+  if (!ecode) {
+    zz_core_blend(K, cmap, lr8);
+    P->ms_pos  = P->ms_end = 0;
+    P->ms_err  = 0;
+    P->pcm_err = 0;
+    P->pcm_cnt = 0;
+    P->done    = 0;
+    seek_init(P);
+  }
+  return ecode;
+}
+
+/* Accumulators after a number of ticks (as computed by zz_tick()). */
+static void
+seek_clock(play_t * P, u32_t tick)
+{
+  const u64_t ms = (u64_t) tick * 1000u;
+
+  P->ms_pos  = tick ? ( ms - 1000u ) / P->rate : 0;
+  P->ms_end  = ms / P->rate;
+  P->ms_err  = ms % P->rate;
+  P->pcm_err = ( (u64_t) tick * P->pcm_err_tick ) % P->rate;
+}
+
+/* First tick starting at or after ms. */
+static u32_t
+seek_tick(play_t * P, u32_t ms)
+{
+  return ( (u64_t) ms * P->rate + 999u ) / 1000u;
+}
+
+/* ---------------------------------------------------------------------- */
+
+zz_err_t
+zz_seek(play_t * P, u32_t ms)
+{
+  int32_t pcm[SEEK_PCM*2];		/* up to 8 bytes per pcm */
+  zz_err_t ecode = E_OK;
+  u32_t tick;
+  uint8_t opts;
+
+  if (!P)
+    return E_ARG;
+  if (P->core.code)
+    return P->core.code;
+  if (!P->core.mixer || !P->rate)
+    return E_PLA;
+
+  tick = seek_tick(P, ms);
+  dmsg("seek to %lums (tick:%lu) from tick:%lu\n",
+       LU(ms), LU(tick), LU(P->core.tick));
+
+  if (P->seek.cnt) {
+    /* Restore the closest checkpoint unless the current position is
+     * closer. */
+    const u16_t i = ckpt_index(P, tick);
+    if (tick < P->core.tick || ckpt_rec(P,i)->tick > P->core.tick)
+      seek_restore(P, i);
+  } else if (tick < P->core.tick) {
+    ecode = seek_restart(P);
+    if (ecode)
+      return P->core.code = ecode;
+  }
+
+  /* Play the remaining ticks (one at a time to stop on time). */
+  opts = P->core.opts;
+  P->core.opts &= ~ZZ_OPT_SPAN;
+  while (!P->done && (P->pcm_cnt || P->core.tick < tick)) {
+    i16_t n = zz_play(P, pcm, -SEEK_PCM);
+    if (n <= 0) {
+      ecode = -n;
+      break;
+    }
+  }
+  P->core.opts = opts;
+  P->ms_pos = P->ms_end;
+
+  return ecode;
+}
+
+/* ---------------------------------------------------------------------- */
+
+/* Number of ticks before the next sequencer event. */
+static u32_t
+skip_quiet(const core_t * K, u32_t max)
+{
+  const chan_t * C;
+
+  for (C = K->chan; C < K->chan+4; ++C)
+    if ( ! (0x0F & K->mute & C->msk) && C->wait <= max )
+      max = C->wait ? C->wait-1 : 0;
+  return max;
+}
+
+zz_err_t
+zz_skip(play_t * P, u32_t ms)
+{
+  core_t * K;
+  zz_err_t ecode;
+  chan_t * C;
+  u32_t tick, stop = ZZ_EOF;
+
+  if (!P)
+    return E_ARG;
+  K = &P->core;
+  if (K->code)
+    return K->code;
+  if (!K->mixer || !P->rate)
+    return E_PLA;
+
+  tick = seek_tick(P, ms);
+  dmsg("skip to %lums (tick:%lu) from tick:%lu\n",
+       LU(ms), LU(tick), LU(K->tick));
+
+  if (tick < K->tick) {
+    if (P->seek.cnt)
+      seek_restore(P, ckpt_index(P, tick));
+    else if ( (ecode = seek_restart(P)) )
+      return K->code = ecode;
+  }
+
+  /* The first tick that sets the done flag because of the play time
+   * has to be run by zz_tick(). */
+  if (P->ms_max == ZZ_EOF)
+    stop = seek_tick(P, P->ms_len + 1u);
+  else if (P->ms_max)
+    stop = seek_tick(P, P->ms_max + 1u);
+  stop = stop < ZZ_EOF - 1u ? stop + 1u : ZZ_EOF;
+
+  /* Drop the current tick remaining pcm and pending triggers. */
+  P->pcm_cnt = 0;
+  for (C = K->chan; C < K->chan+4; ++C)
+    C->trig = TRIG_NOP;
+
+  while (!P->done && K->tick < tick) {
+    u32_t n = tick - K->tick;
+
+    if (K->tick < stop && n > stop - K->tick - 1u)
+      n = stop - K->tick - 1u;
+    n = skip_quiet(K, n);
+
+    if (n) {
+      /* Nothing happens but waits and portamentos */
+      K->tick += n;
+      K->loop &= 0x0F;
+      for (C = K->chan; C < K->chan+4; ++C) {
+        if (0x0F & K->mute & C->msk)
+          continue;
+        if (C->note.stp)
+          note_slide(&C->note, n);
+        C->wait -= n;
+      }
+      seek_clock(P, K->tick);
+    } else {
+      K->code = zz_tick(P);
+      P->pcm_cnt = 0;
+      if (K->code)
+        return K->code;
+      for (C = K->chan; C < K->chan+4; ++C)
+        C->trig = TRIG_NOP;
+    }
+  }
+
+  if (!P->done) {
+    /* Run the first tick starting at or after ms for the mixer. */
+    K->code = zz_tick(P);
+    if (K->code)
+      return K->code;
+
+    /* The mixer state does not match the new position. Restart all
+     * voices still holding a note at their current pitch. Mixers
+     * trigger the current instrument so notes played with another
+     * instrument are stopped instead. */
+    for (C = K->chan; C < K->chan+4; ++C)
+      if ( (C->trig == TRIG_NOP || C->trig == TRIG_SLIDE)
+           && !(0x0F & K->mute & C->msk) )
+        C->trig = C->note.cur && C->note.ins == K->vset.inst+C->curi
+          ? TRIG_NOTE : TRIG_STOP;
+  } else
+    P->ms_pos = P->ms_end;
+
+  /* Checkpoints would not match a regular play. */
+  P->seek.next = ZZ_EOF;
+
+  return E_OK;
+}
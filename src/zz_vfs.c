@@ -48,12 +48,17 @@ vfs_emsg(const char * dri, int err, const char * fct,
 }
 #endif
 
+/* GB: Drivers can be (un)registered while other threads are looking
+ *     up the table. Slots are claimed and released atomically and
+ *     readers only use their own copy of a slot.
+ */
+
 static int
 vfs_find(zz_vfs_dri_t dri)
 {
   const int max = sizeof(drivers)/sizeof(*drivers);
   int i;
-  for (i=0; i<max && drivers[i] != dri; ++i)
+  for (i=0; i<max && zz_atomic_get(drivers+i) != dri; ++i)
     ;
   return i<max ? i : -1;
 }
@@ -65,16 +70,20 @@ vfs_register(zz_vfs_dri_t dri)
 
   if (dri) {
     i = vfs_find(dri);		    /* looking for this driver slot */
-    if (i < 0)			    /* not found ? */
-      i = vfs_find(0);		    /* looking for a free slot */
-    if (i >= 0) {
-      if (dri->reg(dri) >= 0) {
-	drivers[i] = dri;
-	i = E_OK;
+    if (i < 0 && dri->reg(dri) >= 0) {
+      /* claim a free slot */
+      const int max = sizeof(drivers)/sizeof(*drivers);
+      for (i=0; i<max; ++i) {
+	zz_vfs_dri_t none = 0;
+	if (zz_atomic_cas(drivers+i, &none, dri))
+	  break;
+      }
+      if (i == max) {
+	dri->unreg(dri);
+	i = -1;
       }
-      else
-	i = E_ERR;
     }
+    i = i >= 0 ? E_OK : E_ERR;
     if (i != E_OK )
       (void) vfs_emsg(dri->name,0,"register",0,0);
   }
@@ -89,9 +98,10 @@ vfs_unregister(zz_vfs_dri_t dri)
   if (dri) {
     i = vfs_find(dri);		    /* looking for this driver slot */
     if (i >= 0) {		    /* found ? */
-      int res = drivers[i]->unreg(dri);
+      int res = dri->unreg(dri);
       if (!res) {
-	drivers[i] = 0;
+	zz_vfs_dri_t old = dri;
+	zz_atomic_cas(drivers+i, &old, 0);
 	i = E_OK;
       }
       else if (res < 0) {
@@ -108,31 +118,32 @@ vfs_t
 vfs_new(const char * uri, ...)
 {
   const int max = sizeof(drivers)/sizeof(*drivers);
-  int i, best, k = -1;
+  int i, best;
+  zz_vfs_dri_t dri, found = 0;
   vfs_t vfs = 0;
 
   zz_assert(uri);
-  for (i=0, best=0, k=-1; i<max; ++i) {
+  for (i=0, best=0; i<max; ++i) {
     int score;
-    if (!drivers[i]) continue;
-    score = drivers[i]->ismine(uri);
+    if (!(dri = zz_atomic_get(drivers+i))) continue;
+    score = dri->ismine(uri);
     if (score > best) {
       best = score;
-      k = i;
+      found = dri;
     }
   }
 
-  if (k < 0)
+  if (!found)
     emsg("VFS: not available -- %s\n",uri);
   else {
     va_list list;
     va_start(list,uri);
-    vfs = drivers[k]->new(uri, list);
+    vfs = found->new(uri, list);
     va_end(list);
     if (vfs)
       vfs->err = 0;
     else
-      (void)vfs_emsg(drivers[k]->name,0,"new",0,uri);
+      (void)vfs_emsg(found->name,0,"new",0,uri);
   }
   return vfs;
 }
@@ -193,6 +204,16 @@ vfs_push(vfs_t vfs, const void * ptr, zz_u8_t size)
   return ecode;
 }
 
+void *
+vfs_map(vfs_t vfs, zz_u32_t n, zz_u32_t x)
+{
+  VFS_OR_NIL(vfs);
+  /* GB: Pushed back bytes can not be mapped. */
+  if (!vfs->dri->map || vfs->pb_len != vfs->pb_pos)
+    return 0;
+  return vfs->dri->map(vfs, n, x);
+}
+
 static zz_u32_t pb_read(zz_vfs_t vfs, void * ptr, zz_u32_t size)
 {
   uint8_t * const dst = ptr;
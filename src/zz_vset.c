@@ -0,0 +1,281 @@
+/**
+ * @file   zz_vset.c
+ * @author Benjamin Gerard AKA Ben/OVR
+ * @date   2026-10-16
+ * @brief  Shared voice set cache.
+ */
+
+#define ZZ_DBG_PREFIX "(vce) "
+#include "zz_private.h"
+
+/* GB: Players of the same voice set share one read-only copy of the
+ *     sample memory. Entries are addressed by a hash of the loaded
+ *     content (data and instrument table) and by the preparation
+ *     applied to it (usually by a mixer). The last player to release
+ *     an entry frees it.
+ *
+ *     A preparation never writes into a shared entry. The player
+ *     either steals the entry when it is the only user or works on
+ *     a private copy that is shared afterward. Entries never come
+ *     from a player arena.
+ */
+struct vcache_s {
+  vcache_t  * next;			/**< next entry.            */
+  u64_t	      key;			/**< content hash.          */
+  vset_prep_t prep;			/**< preparation (0:none).  */
+  u32_t	      ref;			/**< number of users.       */
+  vset_t      vset;			/**< shared voice set.      */
+};
+
+static vcache_t * vce_list;
+static u8_t vce_lock;
+
+static void lock(void)
+{
+  u8_t unlocked = 0;
+  while (!zz_atomic_cas(&vce_lock, &unlocked, 1))
+    unlocked = 0;
+}
+
+static void unlock(void)
+{
+  zz_atomic_set(&vce_lock, 0);
+}
+
+/* ---------------------------------------------------------------------- */
+
+#define FNV_INIT  0xCBF29CE484222325ull
+#define FNV_PRIME 0x00000100000001B3ull
+
+static u64_t
+fnv(u64_t h, const uint8_t * s, u32_t n)
+{
+  while (n--)
+    h = ( h ^ *s++ ) * FNV_PRIME;
+  return h;
+}
+
+static u64_t
+vset_hash(const vset_t * const vset)
+{
+  const bin_t * const bin = vset->bin;
+  uint8_t tab[20*8+6];
+  u64_t h = fnv(FNV_INIT, bin->ptr, bin->len);
+  uint8_t * t = tab;
+  u8_t i;
+
+  /* GB: Instruments are hashed by offset as the pcm addresses are
+   *     specific to each load. */
+  for (i=0; i<20; ++i, t+=8) {
+    const inst_t * const inst = vset->inst+i;
+    SET_U32(t+0, inst->pcm ? inst->pcm - bin->ptr : 0);
+    SET_U16(t+4, inst->len);
+    SET_U16(t+6, inst->lpl);
+  }
+  t[0] = vset->khz;
+  t[1] = vset->nbi;
+  SET_U32(t+2, vset->iref);
+  return fnv(h, tab, sizeof(tab));
+}
+
+/* GB: The hash only selects candidates. A hit must hold the same
+ *     instruments and the same samples as the voice set it was
+ *     looked up for. Preparations only write past the end of each
+ *     sample so a prepared entry is checked sample by sample while
+ *     a plain one is checked as a whole.
+ */
+static int
+vce_same(const vcache_t * const E, const vset_t * const vset)
+{
+  const bin_t * const a = E->vset.bin, * const b = vset->bin;
+  u8_t i;
+
+  if (a->len != b->len || E->vset.khz != vset->khz ||
+      E->vset.nbi != vset->nbi || E->vset.iref != vset->iref)
+    return 0;
+
+  for (i=0; i<20; ++i) {
+    const inst_t * const x = E->vset.inst+i, * const y = vset->inst+i;
+    if (x->len != y->len || x->lpl != y->lpl ||
+        (x->pcm ? x->pcm - a->ptr : -1) != (y->pcm ? y->pcm - b->ptr : -1))
+      return 0;
+    if (E->prep && x->len && zz_memcmp(x->pcm, y->pcm, x->len))
+      return 0;
+  }
+  return E->prep || !zz_memcmp(a->ptr, b->ptr, a->len);
+}
+
+/* Caller must hold the lock. */
+static vcache_t *
+vce_find(const u64_t key, const vset_prep_t prep, const vset_t * const vset)
+{
+  vcache_t * E;
+
+  for (E = vce_list; E; E = E->next)
+    if (E->key == key && E->prep == prep && vce_same(E, vset))
+      break;
+  return E;
+}
+
+/* Caller must hold the lock. */
+static void
+vce_unlink(vcache_t * const E)
+{
+  vcache_t ** pE;
+
+  for (pE = &vce_list; *pE != E; pE = &(*pE)->next)
+    zz_assert( *pE );
+  *pE = E->next;
+}
+
+/* Use entry E (referenced) in place of the private voice set. */
+static void
+vce_join(vset_t * const vset, vcache_t * const E)
+{
+  bin_free(&vset->bin);
+  *vset = E->vset;
+  zz_assert( vset->vce == E );
+}
+
+/* Share a private voice set as key/prep or use an existing entry. */
+static zz_err_t
+vce_publish(vset_t * const vset, const u64_t key, const vset_prep_t prep)
+{
+  vcache_t * N = 0, * E;
+  zz_err_t ecode;
+
+  zz_assert( !vset->vce );
+  if ( (ecode = zz_calloc(&N, sizeof(*N))) )
+    return ecode;
+
+  lock();
+  E = vce_find(key, prep, vset);
+  if (E)
+    ++E->ref;
+  else {
+    N->key  = key;
+    N->prep = prep;
+    N->ref  = 1;
+    N->next = vce_list;
+    vset->vce = N;
+    N->vset = *vset;
+    vce_list = N;
+  }
+  unlock();
+
+  if (E) {
+    dmsg("share <%p>\n", (void *)E);
+    zz_free(&N);
+    vce_join(vset, E);
+  } else
+    dmsg("new <%p> %lu bytes\n", (void *)N, LU(vset->bin->max));
+  return E_OK;
+}
+
+/* Make the voice set private again (steal it or copy it). */
+static zz_err_t
+vce_detach(vset_t * const vset)
+{
+  vcache_t * const E = vset->vce;
+  const bin_t * const org = E->vset.bin;
+  bin_t * bin = 0;
+  zz_err_t ecode = E_OK;
+  u8_t i, own;
+
+  lock();
+  if ( (own = E->ref == 1) )
+    vce_unlink(E);
+  unlock();
+
+  if (own) {
+    /* GB: Nobody else can find it now. */
+    dmsg("steal <%p>\n", (void *)E);
+    vset->vce = 0;
+    zz_free(&E);
+    return E_OK;
+  }
+
+  dmsg("copy <%p> %lu bytes\n", (void *)E, LU(org->max));
+  if ( (ecode = bin_alloc(&bin, org->len, org->max - org->len)) )
+    return ecode;
+  zz_memcpy(bin->ptr, org->ptr, org->max);
+  for (i=0; i<20; ++i)
+    if (vset->inst[i].pcm)
+      vset->inst[i].pcm = bin->ptr + ( vset->inst[i].pcm - org->ptr );
+  vset_release(vset);
+  vset->bin = bin;
+  return ecode;
+}
+
+/* ---------------------------------------------------------------------- */
+
+zz_err_t
+vset_share(vset_t * const vset)
+{
+  zz_assert( vset->bin );
+  zz_assert( !vset->vce );
+  return vce_publish(vset, vset_hash(vset), 0);
+}
+
+zz_err_t
+vset_prepare(vset_t * const vset, const vset_prep_t prep)
+{
+  vcache_t * const O = vset->vce, * E;
+  arena_t * old;
+  u64_t key;
+  zz_err_t ecode;
+
+  if (O && O->prep == prep)
+    return E_OK;
+
+  old = arena_use(0);
+  if (!O)
+    ecode = prep(vset);
+  else {
+    key = O->key;
+    lock();
+    E = vce_find(key, prep, &O->vset);
+    if (E)
+      ++E->ref;
+    unlock();
+    if (E) {
+      dmsg("prepared <%p>\n", (void *)E);
+      vset_release(vset);
+      *vset = E->vset;
+      ecode = E_OK;
+    } else if ( !(ecode = vce_detach(vset)) && !(ecode = prep(vset)) )
+      ecode = vce_publish(vset, key, prep);
+  }
+  arena_use(old);
+  return ecode;
+}
+
+void
+vset_release(vset_t * const vset)
+{
+  vcache_t * E = vset->vce;
+  arena_t * old;
+  u32_t ref;
+
+  if (!E) {
+    old = arena_use(0);
+    bin_free(&vset->bin);
+    arena_use(old);
+    return;
+  }
+
+  lock();
+  if ( !(ref = --E->ref) )
+    vce_unlink(E);
+  unlock();
+
+  dmsg("release <%p> #%lu\n", (void *)E, LU(ref));
+  if (!ref) {
+    old = arena_use(0);
+    bin_free(&E->vset.bin);
+    zz_free(&E);
+    arena_use(old);
+  }
+  vset->vce = 0;
+  vset->bin = 0;
+}
@@ -0,0 +1,1213 @@
+/**
+ * @file    zzbench.c
+ * @author  Benjamin Gerard AKA Ben/OVR
+ * @date    2026-10-16
+ * @brief   zingzong benchmark and self-check tool.
+ */
+
+#define ZZ_DBG_PREFIX "(bch) "
+#include "zz_private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/utsname.h>
+
+ZZ_EXTERN_C
+zz_vfs_dri_t zz_file_vfs(void);		/* vfs_file.c */
+
+#ifndef NO_ICE
+ZZ_EXTERN_C
+zz_vfs_dri_t zz_ice_vfs(void);	       /* vfs_ice.c */
+#endif
+
+#define BENCH_PCM  1024			/* pcm per zz_play() call */
+#define LOAD_RUNS  3			/* best of for load timings */
+
+static char me[] = "zzbench";
+
+static int opt_help, opt_players = 64, opt_generate = 4, opt_runs = 1;
+static int opt_hashes, opt_nchecks;
+static int opt_tolerance = 25, opt_threads = 4;
+static long opt_ticks, opt_length = 10000;
+static char * opt_rates = "8000,22050,48000,96000";
+static char * opt_formats = "s16,s32,f32";
+static char * opt_mixers, * opt_output, * opt_save, * opt_check[4];
+
+static const char * const pcm_names[] = { "s16", "s32", "f32" };
+
+/* ----------------------------------------------------------------------
+ * Message and logging
+ * ----------------------------------------------------------------------
+ */
+
+static void mylog(zz_u8_t log, void * user, const char * fmt, va_list list)
+{
+  /* GB: stdout is reserved for the JSON report. */
+  if (log <= ZZ_LOG_WRN)
+    fprintf(stderr, "%s: ", me);
+  vfprintf(stderr, fmt, list);
+  fflush(stderr);
+}
+
+static void print_usage(void)
+{
+  puts(
+    "Usage: zzbench [OPTIONS] [<song.4v|music.4q> ...]\n"
+    "\n"
+    "  Measure the sequencer time per tick with many players. Then\n"
+    "  time loading and rendering with every mixer at each sampling\n"
+    "  rate and pcm format. Without song, generated songs are used.\n"
+    "\n"
+    "  The results are written as a JSON report. They can also be\n"
+    "  saved as a reference for later checks of the rendered pcm\n"
+    "  and of the speed. Channel blending is always the default.\n"
+    "  Every run is also rendered by zz_render_parallel(), in span\n"
+    "  mode and after seeking back (mixers with checkpoints) which\n"
+    "  must all produce the same pcm.\n"
+    "\n"
+    "OPTIONS:\n"
+    " -h --help          Print this message and exit.\n"
+    " -p --players=N     Number of players ticked together (64).\n"
+    " -t --ticks=N       Number of ticks (default: twice the song).\n"
+    " -l --length=MS     Rendered length per run (10000, 0:song).\n"
+    " -r --rates=LIST    Sampling rates (8000,22050,48000,96000).\n"
+    " -e --formats=LIST  Pcm formats (s16,s32,f32).\n"
+    " -m --mixers=LIST   Mixer names or ids (default: all).\n"
+    " -g --generate=N    Number of generated songs (4).\n"
+    " -o --output=FILE   Write the report to FILE (default: stdout).\n"
+    " -n --runs=N        Best of N renders per run (1).\n"
+    " -s --save=FILE     Save the runs as a reference.\n"
+    " -H --hashes        Save the pcm hashes only (no speed).\n"
+    " -c --check=FILE    Check the runs against a reference (up to 4).\n"
+    " -T --tolerance=PCT Speed drop allowed by --check (25).\n"
+    " -j --threads=N     Threads of the parallel render check (4, 0:off).\n"
+    );
+}
+
+/* ----------------------------------------------------------------------
+ * Helpers
+ * ----------------------------------------------------------------------
+ */
+
+static double now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1E9 + ts.tv_nsec;
+}
+
+#define FNV_INIT  0xCBF29CE484222325ull
+#define FNV_PRIME 0x00000100000001B3ull
+
+static u64_t
+fnv(u64_t h, const uint8_t * s, u32_t n)
+{
+  while (n--)
+    h = ( h ^ *s++ ) * FNV_PRIME;
+  return h;
+}
+
+static zz_err_t
+player_open(play_t ** pP, const char * uri)
+{
+  zz_err_t ecode = zz_new(pP);
+  play_t * P = *pP;
+
+  if (!ecode)
+    ecode = zz_load(P, uri, 0, 0);
+  if (!ecode)
+    ecode = zz_init(P, 0, ZZ_EOF);
+  if (!ecode)
+    ecode = zz_setup(P, ZZ_MIXER_DEF, SPR_DEF);
+  return ecode;
+}
+
+static u32_t
+bench_ticks(const play_t * P)
+{
+  return opt_ticks > 0 ? opt_ticks : P->core.song.ticks * 2u + 1u;
+}
+
+static void
+trig_reset(core_t * K)
+{
+  K->chan[0].trig = K->chan[1].trig =
+    K->chan[2].trig = K->chan[3].trig = TRIG_NOP;
+}
+
+/* ----------------------------------------------------------------------
+ * JSON report
+ * ----------------------------------------------------------------------
+ */
+
+static FILE * json;
+
+static void
+json_str(const char * s)
+{
+  fputc('"', json);
+  for ( ; *s; ++s) {
+    const unsigned char c = *s;
+    if (c == '"' || c == '\\')
+      fprintf(json, "\\%c", c);
+    else if (c < 0x20)
+      fprintf(json, "\\u%04x", c);
+    else
+      fputc(c, json);
+  }
+  fputc('"', json);
+}
+
+/* First "model name" of /proc/cpuinfo or "". */
+static void
+cpu_model(char * buf, int max)
+{
+  FILE * f = fopen("/proc/cpuinfo", "r");
+  char line[256];
+
+  *buf = 0;
+  while (f && fgets(line, sizeof(line), f)) {
+    char * s = strchr(line, ':');
+    if (s && !strncmp(line, "model name", 10)) {
+      for (++s; *s == ' '; ++s)
+        ;
+      snprintf(buf, max, "%.*s", (int) strcspn(s, "\n"), s);
+      break;
+    }
+  }
+  if (f)
+    fclose(f);
+}
+
+static void
+json_head(void)
+{
+  struct utsname un;
+  char cpu[128];
+
+  if (uname(&un))
+    strcpy(un.machine, "?");
+  cpu_model(cpu, sizeof(cpu));
+
+  fprintf(json, "{\n  \"version\": ");
+  json_str(zz_core_version());
+  fprintf(json, ",\n  \"machine\": ");
+  json_str(un.machine);
+  fprintf(json, ",\n  \"cpu\": ");
+  json_str(cpu);
+  fprintf(json, ",\n  \"simd\": %s",
+#ifdef NO_SIMD
+          "false"
+#else
+          "true"
+#endif
+    );
+  fprintf(json, ",\n  \"length_ms\": %ld,\n  \"songs\": [", opt_length);
+}
+
+/* ----------------------------------------------------------------------
+ * Generated songs
+ * ----------------------------------------------------------------------
+ */
+
+/* GB: Songs are generated from a fixed seed so the same song is
+ *     benched on every platform and version. Each one has its own
+ *     voice set rate and 8 instruments (saw, square, triangle and
+ *     noise; looped or decaying) played with notes, slides, rests
+ *     and instrument changes on all 4 channels.
+ */
+
+#define GEN_INS   8			/* instruments per voice set */
+#define GEN_NOTES 96			/* events per channel */
+
+static uint32_t gen_seed;
+static char * gen_dir;
+
+/* 0..n-1 (n <= 65536) */
+static u32_t
+gen_rand(u32_t n)
+{
+  gen_seed = gen_seed * 1664525u + 1013904223u;
+  return (gen_seed >> 16) % n;
+}
+
+static void
+gen_wave(uint8_t * pcm, i32_t len, u8_t shape, i32_t per, int decay)
+{
+  i32_t n;
+
+  for (n=0; n<len; ++n) {
+    const i32_t ph = (n % per) * 256 / per - 128;
+    const i32_t amp = decay ? len-n : len;
+    i32_t v;
+
+    switch (shape & 3) {
+    case 0:  v = ph; break;
+    case 1:  v = ph < 0 ? -128 : 127; break;
+    case 2:  v = 2 * (ph < 0 ? -ph : ph) - 128; break;
+    default: v = (i32_t) gen_rand(256) - 128; break;
+    }
+    pcm[n] = 128 + (int) ( (int64_t) v * amp * 3 / ( (int64_t) len * 4 ) );
+  }
+}
+
+/* Voice set (returns file size). */
+static u32_t
+gen_vset(uint8_t * buf, u8_t khz)
+{
+  u32_t off = 222;
+  u8_t i;
+
+  zz_memclr(buf, off);
+  buf[0] = khz;
+  buf[1] = GEN_INS+1;
+  for (i=0; i<GEN_INS; ++i) {
+    const i32_t len = 1024 + gen_rand(7168);
+    const i32_t per = 16 + gen_rand(112);
+    const i32_t lpl = i & 1 ? 0 : per * ( (len>>1) / per );
+
+    buf[2+7*i] = 'A'+i;
+    SET_U32(buf+2+7*20+4*i, off);
+    SET_U32(buf+off+0, lpl ? (u32_t) lpl << 16 : 0xFFFFFFFF);
+    SET_U32(buf+off+4, (u32_t) len << 16);
+    gen_wave(buf+off+8, len, i>>1, per, !lpl);
+    off += 8+len;
+  }
+  return off;
+}
+
+static uint8_t *
+gen_seq(uint8_t * s, u16_t cmd, u16_t len, u32_t stp, u32_t par)
+{
+  SET_U16(s+0, cmd);
+  SET_U16(s+2, len);
+  SET_U32(s+4, stp);
+  SET_U32(s+8, par);
+  return s+12;
+}
+
+/* Song (returns file size). */
+static u32_t
+gen_song(uint8_t * buf, u8_t khz)
+{
+  /* 2^(n/12) in 16.16 fixed point. */
+  static const u32_t semi[12] = {
+    65536, 69433, 73562, 77936, 82570, 87480,
+    92682, 98193, 104032, 110218, 116772, 123715
+  };
+  uint8_t * s = buf+16;
+  u8_t k;
+
+  zz_memclr(buf, 16);
+  SET_U16(buf+0, khz);
+  SET_U16(buf+2, 16);			/* bar */
+  SET_U16(buf+4, 4);			/* tempo */
+  buf[6] = buf[7] = 4;			/* 4/4 */
+
+  for (k=0; k<4; ++k) {
+    u32_t cur = 0;
+    int i;
+
+    s = gen_seq(s, 'V', 0, 0, gen_rand(GEN_INS) << 2);
+    s = gen_seq(s, 'l', 0, 0, 0);
+    for (i=0; i<GEN_NOTES; ++i) {
+      const u32_t r = gen_rand(16);
+      const u16_t len = 4 * ( 1 + gen_rand(6) );
+      const u32_t oct = gen_rand(3);
+      const u32_t stp = oct == 1 ? semi[gen_rand(12)]
+        : oct ? semi[gen_rand(12)] << 1 : semi[gen_rand(12)] >> 1;
+
+      if (r == 0) {
+        s = gen_seq(s, 'R', len, 0, 0);
+        cur = 0;
+      } else if (r < 3)
+        s = gen_seq(s, 'V', 0, 0, gen_rand(GEN_INS) << 2);
+      else if (r < 5 && cur && cur != stp) {
+        int32_t par = ( (int32_t) stp - (int32_t) cur ) / len;
+        if (!par)
+          par = stp > cur ? 1 : -1;
+        s = gen_seq(s, 'S', len, stp, (u32_t) par);
+        cur = stp;
+      } else {
+        s = gen_seq(s, 'P', len, stp, 0);
+        cur = stp;
+      }
+    }
+    s = gen_seq(s, 'L', 0, 0, 1l << 16);
+    s = gen_seq(s, 'F', 0, 0, 0);
+  }
+  return s - buf;
+}
+
+static zz_err_t
+gen_write(const char * path, const uint8_t * buf, u32_t len)
+{
+  FILE * f = fopen(path, "wb");
+  zz_err_t ecode = E_OK;
+
+  if (!f || fwrite(buf, 1, len, f) != len)
+    ecode = E_SYS;
+  if (f && fclose(f))
+    ecode = E_SYS;
+  if (ecode)
+    emsg("could not write -- %s\n", path);
+  return ecode;
+}
+
+static char *
+gen_path(int i, const char * ext)
+{
+  char * path = malloc(strlen(gen_dir) + 32);
+  if (path)
+    sprintf(path, "%s/gen-%02d.%s", gen_dir, i+1, ext);
+  return path;
+}
+
+/* Generate n songs (and their voice sets) in a temporary directory. */
+static zz_err_t
+gen_songs(int n, char ** uris)
+{
+  static const u8_t khz[] = { 8, 10, 12, 16, 20 };
+  const char * tmp = getenv("TMPDIR");
+  uint8_t * buf = 0;
+  zz_err_t ecode;
+  int i;
+
+  if (!tmp || !*tmp)
+    tmp = "/tmp";
+  gen_dir = malloc(strlen(tmp) + 16);
+  if (!gen_dir)
+    return E_MEM;
+  sprintf(gen_dir, "%s/zzbench-XXXXXX", tmp);
+  if (!mkdtemp(gen_dir)) {
+    emsg("could not create a temporary directory -- %s\n", gen_dir);
+    free(gen_dir);
+    gen_dir = 0;
+    return E_SYS;
+  }
+  dmsg("generating %d songs in \"%s\"\n", n, gen_dir);
+
+  ecode = zz_malloc(&buf, 222 + GEN_INS * (8+8192));
+  for (i=0; !ecode && i<n; ++i) {
+    char * set = gen_path(i, "set");
+    u32_t len;
+
+    gen_seed = 0x5A5A0000 + i;
+    uris[i] = gen_path(i, "4v");
+    if (!set || !uris[i])
+      ecode = E_MEM;
+    if (!ecode) {
+      len = gen_vset(buf, khz[i % sizeof(khz)]);
+      ecode = gen_write(set, buf, len);
+    }
+    if (!ecode) {
+      len = gen_song(buf, khz[i % sizeof(khz)]);
+      ecode = gen_write(uris[i], buf, len);
+    }
+    free(set);
+  }
+  zz_free(&buf);
+  return ecode;
+}
+
+static void
+gen_clean(int n, char ** uris)
+{
+  int i;
+
+  if (!gen_dir)
+    return;
+  for (i=0; i<n; ++i) {
+    char * set = gen_path(i, "set");
+    if (set)
+      remove(set);
+    if (uris[i])
+      remove(uris[i]);
+    free(set);
+    free(uris[i]);
+  }
+  rmdir(gen_dir);
+  free(gen_dir);
+  gen_dir = 0;
+}
+
+/* ----------------------------------------------------------------------
+ * Sequencer
+ * ----------------------------------------------------------------------
+ */
+
+static zz_err_t
+core_bench(const char * uri, double * pns)
+{
+  play_t ** P;
+  zz_err_t ecode = E_OK;
+  u32_t tick, ticks = 0;
+  int i, n = 0;
+  double t0;
+
+  ecode = zz_calloc(&P, opt_players * sizeof(*P));
+  for (n=0; !ecode && n<opt_players; ++n)
+    ecode = player_open(&P[n], uri);
+
+  if (!ecode) {
+    ticks = bench_ticks(P[0]);
+    t0 = now_ns();
+    for (tick = 0; !ecode && tick < ticks; ++tick)
+      for (i = 0; !ecode && i < n; ++i) {
+        ecode = zz_core_tick(&P[i]->core);
+        trig_reset(&P[i]->core);
+      }
+    *pns = (now_ns() - t0) / ((double) ticks * n);
+  }
+
+  while (n > 0)
+    zz_del(&P[--n]);
+  zz_free(&P);
+  return ecode;
+}
+
+/* ----------------------------------------------------------------------
+ * Loading
+ * ----------------------------------------------------------------------
+ */
+
+static double
+best(double a, double b)
+{
+  return a < b ? a : b;
+}
+
+/* Time zz_load() and for .4v its song and voice set parts. */
+static zz_err_t
+load_bench(const char * uri, const play_t * I)
+{
+  double load_ns = 1E30, song_ns = 1E30, vset_ns = 1E30, t0;
+  zz_err_t ecode = E_OK;
+  int run;
+
+  for (run = 0; !ecode && run < LOAD_RUNS; ++run) {
+    play_t * P = 0;
+
+    if ( !(ecode = zz_new(&P)) ) {
+      t0 = now_ns();
+      ecode = zz_load(P, uri, 0, 0);
+      load_ns = best(load_ns, now_ns() - t0);
+    }
+    zz_del(&P);
+
+    if (!ecode && I->format == ZZ_FORMAT_4V) {
+      song_t song;
+      vset_t vset;
+
+      zz_memclr(&song, sizeof(song));
+      t0 = now_ns();
+      ecode = song_load(&song, uri);
+      song_ns = best(song_ns, now_ns() - t0);
+      bin_free(&song.bin);
+
+      zz_memclr(&vset, sizeof(vset));
+      if (!ecode) {
+        t0 = now_ns();
+        ecode = vset_load(&vset, I->vseturi->ptr);
+        vset_ns = best(vset_ns, now_ns() - t0);
+        vset_release(&vset);
+      }
+    }
+  }
+
+  if (!ecode) {
+    fprintf(json, ",\n      \"load_ns\": %.0f", load_ns);
+    if (I->format == ZZ_FORMAT_4V)
+      fprintf(json, ",\n      \"song_ns\": %.0f,\n      \"vset_ns\": %.0f",
+              song_ns, vset_ns);
+  }
+  return ecode;
+}
+
+/* ----------------------------------------------------------------------
+ * Reference
+ * ----------------------------------------------------------------------
+ */
+
+/* GB: A reference is a text file with one line per run made of the
+ *     song file name, the mixer, the sampling rate, the pcm format,
+ *     the rendered length, the pcm hash and the realtime factor. It
+ *     is written by --save and compared to by --check. Hashes must
+ *     match. The realtime factor must not drop more than --tolerance
+ *     percent below the reference one, which only makes sense for a
+ *     reference saved on the same machine. A zero realtime factor
+ *     (--hashes) is not checked: the hashes do not depend on the
+ *     machine and such a reference is shipped with the sources.
+ */
+
+#define REF_KEY 160
+
+typedef struct ref_s ref_t;
+struct ref_s {
+  char	 key[REF_KEY];			/**< song mixer spr pcm ms. */
+  u64_t	 hash;				/**< pcm hash.              */
+  double rtf;				/**< realtime factor.       */
+  int	 seen;				/**< checked.               */
+};
+
+static ref_t * refs;
+static int nrefs, maxrefs, nfails;
+static FILE * save;
+
+static zz_err_t
+ref_load(const char * path)
+{
+  FILE * f = fopen(path, "r");
+  char line[256];
+
+  if (!f) {
+    emsg("could not open -- %s\n", path);
+    return E_SYS;
+  }
+  while (fgets(line, sizeof(line), f)) {
+    char song[64], mixer[32], pcm[8];
+    unsigned long spr, hash_hi, hash_lo;
+    long ms;
+    double rtf;
+    ref_t * R;
+
+    if (*line == '#' || *line == '\n')
+      continue;
+    if (sscanf(line, "%63s %31s %lu %7s %ld %8lx%8lx %lf",
+               song, mixer, &spr, pcm, &ms,
+               &hash_hi, &hash_lo, &rtf) != 8) {
+      emsg("invalid reference line -- %s", line);
+      continue;
+    }
+    if (nrefs == maxrefs) {
+      const int max = maxrefs ? maxrefs*2 : 64;
+      if ( !(R = realloc(refs, max * sizeof(*refs))) ) {
+        fclose(f);
+        return E_MEM;
+      }
+      refs = R;
+      maxrefs = max;
+    }
+    R = refs + nrefs++;
+    snprintf(R->key, REF_KEY, "%s %s %lu %s %ld", song, mixer, spr, pcm, ms);
+    R->hash = (u64_t) hash_hi << 32 | hash_lo;
+    R->rtf  = rtf;
+    R->seen = 0;
+  }
+  fclose(f);
+  dmsg("%d reference runs in \"%s\"\n", nrefs, path);
+  return E_OK;
+}
+
+static void
+ref_key(char * key, const char * uri, const char * name, u32_t spr,
+        u8_t fmt)
+{
+  const char * song = strrchr(uri, '/');
+  snprintf(key, REF_KEY, "%s %s %lu %s %ld",
+           song ? song+1 : uri, name, LU(spr), pcm_names[fmt], opt_length);
+}
+
+/* Reference hash of a run (def if there is none). */
+static u64_t
+ref_hash(const char * uri, const char * name, u32_t spr, u8_t fmt,
+         u64_t def)
+{
+  char key[REF_KEY];
+  int i;
+
+  ref_key(key, uri, name, spr, fmt);
+  for (i=0; i<nrefs; ++i)
+    if (!strcmp(refs[i].key, key))
+      return refs[i].hash;
+  return def;
+}
+
+/* Save and/or check one run. */
+static void
+ref_run(const char * uri, const char * name, u32_t spr, u8_t fmt,
+        u64_t hash, double rtf)
+{
+  char key[REF_KEY];
+  int i, seen;
+
+  ref_key(key, uri, name, spr, fmt);
+  if (save)
+    fprintf(save, "%s %016llx %.1f\n", key, (unsigned long long) hash,
+            opt_hashes ? 0.0 : rtf);
+  if (!opt_nchecks)
+    return;
+
+  for (i=0, seen=0; i<nrefs; ++i) {
+    ref_t * const R = refs+i;
+    if (strcmp(R->key, key))
+      continue;
+    R->seen = seen = 1;
+    if (R->hash != hash) {
+      emsg("<%s> pcm differs (%016llx != %016llx)\n", key,
+           (unsigned long long) hash, (unsigned long long) R->hash);
+      ++nfails;
+    } else if (rtf < R->rtf * (100 - opt_tolerance) / 100) {
+      emsg("<%s> too slow (%.1fx < %.1fx realtime)\n", key, rtf, R->rtf);
+      ++nfails;
+    }
+  }
+  if (!seen)
+    wmsg("no reference for <%s>\n", key);
+}
+
+/* ----------------------------------------------------------------------
+ * Rendering
+ * ----------------------------------------------------------------------
+ */
+
+typedef struct run_s run_t;
+struct run_s {
+  double setup_ns;			/**< zz_setup() time.     */
+  double mix_ns;			/**< zz_play() time.      */
+  u32_t	 frames;			/**< rendered pcm.        */
+  u32_t	 ticks;				/**< played ticks.        */
+  u32_t	 spr;				/**< mixer sampling rate. */
+  u64_t	 hash;				/**< rendered pcm hash.   */
+};
+
+/* Render once. Returns -1 if the pcm format is not supported. */
+static zz_err_t
+mix_run(const char * uri, u8_t mid, u32_t spr, u8_t fmt, run_t * run)
+{
+  static int32_t pcm[BENCH_PCM*2];
+  play_t * P = 0;
+  zz_err_t ecode;
+  double t0;
+
+  zz_memclr(run, sizeof(*run));
+  run->hash = FNV_INIT;
+
+  ecode = zz_new(&P);
+  if (!ecode)
+    ecode = zz_load(P, uri, 0, 0);
+  if (!ecode)
+    ecode = zz_init(P, 0, opt_length ? (u32_t) opt_length : ZZ_EOF);
+  if (!ecode) {
+    t0 = now_ns();
+    ecode = zz_setup(P, mid, spr);
+    run->setup_ns = now_ns() - t0;
+  }
+  if (!ecode)
+    zz_core_pcm(&P->core, fmt);
+  if (!ecode && zz_core_pcm(&P->core, ZZ_PCM_F32+1) != fmt) {
+    zz_del(&P);
+    return -1;
+  }
+
+  while (!ecode) {
+    zz_i16_t n;
+
+    t0 = now_ns();
+    n = zz_play(P, pcm, BENCH_PCM);
+    run->mix_ns += now_ns() - t0;
+    if (n <= 0) {
+      ecode = -n;
+      break;
+    }
+    run->hash = fnv(run->hash, (const uint8_t *) pcm, n*ZZ_PCM_SIZE(fmt));
+    run->frames += n;
+  }
+
+  if (!ecode) {
+    run->spr   = P->core.spr;
+    run->ticks = P->core.tick;
+  }
+  zz_del(&P);
+  return ecode;
+}
+
+/* Render n pcm with zz_render_parallel() and compare to hash. */
+static zz_err_t
+par_run(const char * uri, u8_t mid, const char * name, u32_t spr,
+        u8_t fmt, u32_t n, u64_t hash)
+{
+  play_t * P = 0;
+  uint8_t * pcm = 0;
+  zz_err_t ecode;
+  u32_t m = n;
+  int32_t tail[16];
+
+  ecode = zz_malloc(&pcm, mulu32(n ? n : 1, ZZ_PCM_SIZE(fmt)));
+  if (!ecode)
+    ecode = zz_new(&P);
+  if (!ecode)
+    ecode = zz_load(P, uri, 0, 0);
+  if (!ecode)
+    ecode = zz_init(P, 0, opt_length ? (u32_t) opt_length : ZZ_EOF);
+  if (!ecode)
+    ecode = zz_setup(P, mid, spr);
+  if (!ecode) {
+    zz_core_pcm(&P->core, fmt);
+    ecode = zz_render_parallel(P, pcm, &m, opt_threads);
+  }
+  if (!ecode) {
+    /* GB: Same pcm and the player must be at the end as well. */
+    const zz_i16_t r = zz_play(P, tail, 4);
+    if (m != n || r != 0
+        || fnv(FNV_INIT, pcm, mulu32(n, ZZ_PCM_SIZE(fmt))) != hash) {
+      emsg("%s: %s @%luhz %s parallel render differs"
+           " (%lu/%lu pcm)\n", uri, name, LU(spr),
+           pcm_names[fmt], LU(m), LU(n));
+      ++nfails;
+    }
+  }
+  zz_del(&P);
+  zz_free(&pcm);
+  return ecode;
+}
+
+/* Play to the end (or until *ptick ticks have been played when ptick
+ * is set) and hash the pcm. */
+static zz_err_t
+hash_play(play_t * P, u8_t fmt, u64_t * phash, const u32_t * ptick)
+{
+  static int32_t pcm[BENCH_PCM*2];
+
+  for (;;) {
+    zz_i16_t n;
+
+    /* GB: Same stop condition as zz_seek(). */
+    if (ptick && !P->pcm_cnt && P->core.tick >= *ptick)
+      return E_OK;
+    n = zz_play(P, pcm, -BENCH_PCM);
+    if (n <= 0)
+      return -n;
+    *phash = fnv(*phash, (const uint8_t *) pcm, n*ZZ_PCM_SIZE(fmt));
+  }
+}
+
+/* Render in span mode, then seek back and render from there. Both
+ * must produce the pcm of hash. */
+static zz_err_t
+eqv_run(const char * uri, u8_t mid, const char * name, u32_t spr,
+        u8_t fmt, u64_t hash)
+{
+  play_t * P = 0;
+  zz_err_t ecode = E_OK;
+  u64_t h, mark;
+  u32_t ms, tick;
+  int span;
+
+  for (span=1; !ecode && span>=0; --span) {
+    const char * what = span ? "span" : "seek";
+
+    h = FNV_INIT;
+    ecode = zz_new(&P);
+    if (!ecode)
+      ecode = zz_load(P, uri, 0, 0);
+    if (!ecode)
+      ecode = zz_init(P, 0, opt_length ? (u32_t) opt_length : ZZ_EOF);
+    if (!ecode && span)
+      zz_core_opts(&P->core, 0, ZZ_OPT_SPAN);
+    if (!ecode)
+      ecode = zz_setup(P, mid, spr);
+    if (!ecode)
+      zz_core_pcm(&P->core, fmt);
+    if (!ecode && !span) {
+      if (!P->core.mixer->save || !P->core.mixer->restore) {
+        zz_del(&P);
+        break;
+      }
+      /* GB: Play to the end remembering the hash at the seek
+       *     position, just after a checkpoint so that the restored
+       *     state matters. Then seek back there. */
+      ms = ( opt_length ? (u32_t) opt_length : P->ms_len ) / 10u * 7u;
+      tick = (u64_t) ms * P->rate / 1000u;
+      if (P->seek.every && tick > P->seek.every)
+        ms = (u64_t) (tick / P->seek.every * P->seek.every + 1u)
+          * 1000u / P->rate;
+      tick = ( (u64_t) ms * P->rate + 999u ) / 1000u;
+      ecode = hash_play(P, fmt, &h, &tick);
+      mark = h;
+      if (!ecode)
+        ecode = hash_play(P, fmt, &h, 0);
+      if (!ecode && h == hash) {
+        h = mark;
+        ecode = zz_seek(P, ms);
+      }
+    }
+    if (!ecode)
+      ecode = hash_play(P, fmt, &h, 0);
+    if (!ecode && h != hash) {
+      emsg("%s: %s @%luhz %s %s render differs\n",
+           uri, name, LU(spr), pcm_names[fmt], what);
+      ++nfails;
+    }
+    zz_del(&P);
+  }
+  return ecode;
+}
+
+/* Best of --runs renders. *pfirst is cleared once a record is written. */
+static zz_err_t
+mix_bench(const char * uri, u8_t mid, u32_t spr, u8_t fmt, int * pfirst)
+{
+  const char * name = "?", * desc;
+  zz_err_t ecode;
+  run_t run, best;
+  double rtf;
+  int i;
+
+  zz_mixer_info(mid, &name, &desc);
+  ecode = mix_run(uri, mid, spr, fmt, &best);
+  for (i=1; !ecode && i<opt_runs; ++i)
+    if ( !(ecode = mix_run(uri, mid, spr, fmt, &run)) ) {
+      if (run.hash != best.hash) {
+        emsg("%s: %s @%luhz %s is not deterministic\n",
+             uri, name, LU(spr), pcm_names[fmt]);
+        ++nfails;
+      }
+      if (run.setup_ns < best.setup_ns)
+        best.setup_ns = run.setup_ns;
+      if (run.mix_ns < best.mix_ns)
+        best.mix_ns = run.mix_ns;
+    }
+
+  if (ecode == -1) {
+    dmsg("%s: %s not supported\n", name, pcm_names[fmt]);
+    return E_OK;
+  }
+  if (ecode) {
+    emsg("%s: %s @%luhz %s failed (%d)\n",
+         uri, name, LU(spr), pcm_names[fmt], ecode);
+    return ecode;
+  }
+
+  if (opt_threads && best.frames
+      && (ecode = par_run(uri, mid, name, spr, fmt,
+                             best.frames, best.hash))) {
+    emsg("%s: %s @%luhz %s parallel render failed (%d)\n",
+         uri, name, LU(spr), pcm_names[fmt], ecode);
+    return ecode;
+  }
+
+  ecode = eqv_run(uri, mid, name, spr, fmt,
+                  ref_hash(uri, name, best.spr, fmt, best.hash));
+  if (ecode) {
+    emsg("%s: %s @%luhz %s span/seek render failed (%d)\n",
+         uri, name, LU(spr), pcm_names[fmt], ecode);
+    return ecode;
+  }
+
+  rtf = best.mix_ns > 0
+    ? best.frames * 1E9 / ( (double) best.spr * best.mix_ns ) : 0.0;
+  fprintf(json, "%s\n        { \"mixer\": ", *pfirst ? "" : ",");
+  json_str(name);
+  fprintf(json,
+          ", \"id\": %hu, \"spr\": %lu, \"pcm\": \"%s\",\n"
+          "          \"setup_ns\": %.0f, \"frames\": %lu,"
+          " \"ticks\": %lu, \"render_ns\": %.0f,\n"
+          "          \"ns_per_frame\": %.2f, \"ns_per_tick\": %.1f,"
+          " \"realtime\": %.1f, \"hash\": \"%016llx\" }",
+          HU(mid), LU(best.spr), pcm_names[fmt], best.setup_ns,
+          LU(best.frames), LU(best.ticks), best.mix_ns,
+          best.frames ? best.mix_ns / best.frames : 0.0,
+          best.ticks ? best.mix_ns / best.ticks : 0.0,
+          rtf, (unsigned long long) best.hash);
+  *pfirst = 0;
+  imsg("%s: %-10s %5luhz %s %8.1fx realtime %6.2f ns/pcm\n",
+       uri, name, LU(best.spr), pcm_names[fmt], rtf,
+       best.frames ? best.mix_ns / best.frames : 0.0);
+
+  ref_run(uri, name, best.spr, fmt, best.hash, rtf);
+  return E_OK;
+}
+
+/* ----------------------------------------------------------------------
+ * Options
+ * ----------------------------------------------------------------------
+ */
+
+/* Mixers to bench as a mask of mixer ids. */
+static zz_err_t
+mixer_mask(u32_t * pmask)
+{
+  char * list, * tok, * end;
+  const char * name, * desc;
+  u8_t id;
+
+  *pmask = 0;
+  if (!opt_mixers) {
+    for (id=0; id<32 && zz_mixer_info(id,&name,&desc) == id; ++id)
+      *pmask |= 1ul << id;
+    return E_OK;
+  }
+
+  list = strdup(opt_mixers);
+  if (!list)
+    return E_MEM;
+  for (tok = strtok(list, ","); tok; tok = strtok(0, ",")) {
+    long v = strtol(tok, &end, 10);
+    if (*end)
+      for (v=0; v<32 && zz_mixer_info(v,&name,&desc) == v
+             && strcmp(name, tok); ++v)
+        ;
+    if (v < 0 || v >= 32 || zz_mixer_info(v,&name,&desc) != v) {
+      emsg("invalid mixer -- %s\n", tok);
+      free(list);
+      return E_ARG;
+    }
+    *pmask |= 1ul << v;
+  }
+  free(list);
+  return E_OK;
+}
+
+/* Parse a comma separated list of sampling rates. */
+static int
+rate_list(u32_t * rates, int max)
+{
+  char * list = strdup(opt_rates), * tok, * end;
+  int n = 0;
+
+  for (tok = list ? strtok(list, ",") : 0; tok; tok = strtok(0, ",")) {
+    const long v = strtol(tok, &end, 10);
+    const long hz = *end == 'k' && !end[1] ? v*1000 : *end ? -1 : v;
+    if (hz < SPR_MIN || hz > SPR_MAX || n >= max) {
+      emsg("invalid sampling rate -- %s\n", tok);
+      n = -1;
+      break;
+    }
+    rates[n++] = hz;
+  }
+  free(list);
+  return n;
+}
+
+/* Parse a comma separated list of pcm formats. */
+static int
+format_list(u8_t * fmts, int max)
+{
+  char * list = strdup(opt_formats), * tok;
+  int n = 0;
+
+  for (tok = list ? strtok(list, ",") : 0; tok; tok = strtok(0, ",")) {
+    u8_t f;
+    for (f=0; f<3 && strcmp(tok, pcm_names[f]); ++f)
+      ;
+    if (f >= 3 || n >= max) {
+      emsg("invalid pcm format -- %s\n", tok);
+      n = -1;
+      break;
+    }
+    fmts[n++] = f;
+  }
+  free(list);
+  return n;
+}
+
+/* ----------------------------------------------------------------------
+ * Main
+ * ----------------------------------------------------------------------
+ */
+
+static zz_err_t
+song_bench(const char * uri, u32_t mmask,
+           const u32_t * rates, int nrates,
+           const u8_t * fmts, int nfmts)
+{
+  play_t * I = 0;
+  zz_err_t ecode;
+  double tick_ns = 0;
+  int first = 1, r, f;
+  u8_t id;
+
+  /* Song info */
+  ecode = zz_new(&I);
+  if (!ecode)
+    ecode = zz_load(I, uri, 0, 0);
+  if (!ecode)
+    ecode = zz_init(I, 0, ZZ_EOF);
+  if (ecode) {
+    emsg("%s: could not load song (%d)\n", uri, ecode);
+    zz_del(&I);
+    return ecode;
+  }
+  fprintf(json, "\n    {\n      \"uri\": ");
+  json_str(uri);
+  fprintf(json, ",\n      \"format\": \"%s\", \"khz\": %hu, \"rate\": %hu,"
+          " \"ticks\": %lu, \"ms\": %lu",
+          I->format == ZZ_FORMAT_4Q ? "4q" : "4v",
+          HU(I->core.song.khz), HU(I->rate),
+          LU(I->core.song.ticks), LU(I->ms_len));
+
+  ecode = load_bench(uri, I);
+
+  /* Sequencer */
+  if (!ecode)
+    ecode = core_bench(uri, &tick_ns);
+  if (!ecode) {
+    imsg("%s: %d players -- sequencer: %.1f ns/tick\n",
+         uri, opt_players, tick_ns);
+    fprintf(json, ",\n      \"core\": { \"players\": %d,"
+            " \"ns_per_tick\": %.1f }", opt_players, tick_ns);
+  }
+
+  /* Mixers */
+  fprintf(json, ",\n      \"mixers\": [");
+  for (id=0; !ecode && id<32; ++id) {
+    if ( !(mmask & (1ul << id)) )
+      continue;
+    for (r=0; !ecode && r<nrates; ++r)
+      for (f=0; !ecode && f<nfmts; ++f)
+        ecode = mix_bench(uri, id, rates[r], fmts[f], &first);
+  }
+  fprintf(json, "\n      ]\n    }");
+
+  zz_del(&I);
+  return ecode;
+}
+
+int main(int argc, char *argv[])
+{
+  static char sopts[] = "hp:t:l:r:e:m:g:o:n:s:Hc:T:j:";
+  static struct option lopts[] = {
+    { "help",	  0, 0, 'h' },
+    { "players=", 1, 0, 'p' },
+    { "ticks=",	  1, 0, 't' },
+    { "length=",  1, 0, 'l' },
+    { "rates=",	  1, 0, 'r' },
+    { "formats=", 1, 0, 'e' },
+    { "mixers=",  1, 0, 'm' },
+    { "generate=",1, 0, 'g' },
+    { "output=",  1, 0, 'o' },
+    { "runs=",	  1, 0, 'n' },
+    { "save=",	  1, 0, 's' },
+    { "hashes",	  0, 0, 'H' },
+    { "check=",	  1, 0, 'c' },
+    { "tolerance=",1, 0, 'T' },
+    { "threads=", 1, 0, 'j' },
+    { 0 }
+  };
+  u32_t rates[16], mmask = 0;
+  u8_t fmts[3];
+  char ** uris = 0;
+  int c, i, nuris, nrates, nfmts, ecode = ZZ_OK;
+
+  argv[0] = me;
+  zz_log_fun(mylog,0);
+  zz_log_bit(0, (1<<ZZ_LOG_DBG)-1);
+
+  while ((c = getopt_long (argc, argv, sopts, lopts, 0)) != -1) {
+    switch (c) {
+    case 'h': opt_help++; break;
+    case 'p': opt_players = atoi(optarg); break;
+    case 't': opt_ticks = atol(optarg); break;
+    case 'l': opt_length = atol(optarg); break;
+    case 'r': opt_rates = optarg; break;
+    case 'e': opt_formats = optarg; break;
+    case 'm': opt_mixers = optarg; break;
+    case 'g': opt_generate = atoi(optarg); break;
+    case 'o': opt_output = optarg; break;
+    case 'n': opt_runs = atoi(optarg); break;
+    case 's': opt_save = optarg; break;
+    case 'H': opt_hashes = 1; break;
+    case 'c':
+      if (opt_nchecks == sizeof(opt_check)/sizeof(*opt_check)) {
+        emsg("too many references -- %s\n", optarg);
+        return ZZ_EARG;
+      }
+      opt_check[opt_nchecks++] = optarg;
+      break;
+    case 'T': opt_tolerance = atoi(optarg); break;
+    case 'j': opt_threads = atoi(optarg); break;
+    default: return ZZ_EARG;
+    }
+  }
+
+  if (opt_help) {
+    print_usage();
+    return ZZ_OK;
+  }
+  nrates = rate_list(rates, sizeof(rates)/sizeof(*rates));
+  nfmts = format_list(fmts, sizeof(fmts));
+  if (opt_players < 1 || opt_length < 0 || nrates < 1 || nfmts < 1
+      || opt_runs < 1 || opt_tolerance < 0 || opt_tolerance > 100
+      || opt_threads < 0 || opt_threads > 255
+      || (optind >= argc && opt_generate < 1) || mixer_mask(&mmask)) {
+    emsg("invalid arguments. Try --help.\n");
+    return ZZ_EARG;
+  }
+
+  ecode = zz_vfs_add(zz_file_vfs());
+#ifndef NO_ICE
+  if (!ecode)
+    ecode = zz_vfs_add(zz_ice_vfs());
+#endif
+
+  /* Songs from the command line or generated ones. */
+  nuris = optind < argc ? argc - optind : opt_generate;
+  if (!ecode && !(uris = calloc(nuris, sizeof(*uris))))
+    ecode = E_MEM;
+  if (!ecode) {
+    if (optind < argc)
+      for (i=0; i<nuris; ++i)
+        uris[i] = argv[optind+i];
+    else
+      ecode = gen_songs(nuris, uris);
+  }
+
+  /* Fixed settings for comparable runs. */
+  zz_core_blend(0, ZZ_MAP_ABCD, BLEND_DEF);
+
+  for (i=0; !ecode && i<opt_nchecks; ++i)
+    ecode = ref_load(opt_check[i]);
+  if (!ecode && opt_save && !(save = fopen(opt_save, "w"))) {
+    emsg("could not create -- %s\n", opt_save);
+    ecode = E_SYS;
+  }
+  if (save)
+    fprintf(save, "# %s reference -- %s\n", me, zz_core_version());
+
+  json = stdout;
+  if (!ecode && opt_output && strcmp(opt_output, "-")
+      && !(json = fopen(opt_output, "w"))) {
+    emsg("could not create -- %s\n", opt_output);
+    ecode = E_SYS;
+  }
+
+  if (!ecode) {
+    json_head();
+    for (i=0; !ecode && i<nuris; ++i) {
+      if (i)
+        fputc(',', json);
+      ecode = song_bench(uris[i], mmask, rates, nrates, fmts, nfmts);
+    }
+    fprintf(json, "\n  ]\n}\n");
+    if (json != stdout && fclose(json)) {
+      emsg("could not write -- %s\n", opt_output);
+      ecode = E_SYS;
+    }
+  }
+
+  if (save && fclose(save) && !ecode) {
+    emsg("could not write -- %s\n", opt_save);
+    ecode = E_SYS;
+  }
+  if (!ecode && opt_nchecks) {
+    for (i=0; i<nrefs; ++i)
+      if (!refs[i].seen)
+        wmsg("<%s> not run\n", refs[i].key);
+    imsg("%d reference%s checked: %d failure%s\n",
+         opt_nchecks, opt_nchecks == 1 ? "" : "s",
+         nfails, nfails == 1 ? "" : "s");
+  }
+  if (!ecode && nfails)
+    ecode = ZZ_ERR;
+
+  if (uris && optind >= argc)
+    gen_clean(nuris, uris);
+  free(uris);
+  free(refs);
+  return ecode;
+}